@@ -50,22 +50,31 @@ include(D:/08YYYXXX/QXlsx-master/QXlsx/QXlsx.pri)
 
 # Input
 HEADERS += \
+           besselfunctions.h \
            chartsetting1.h \
            chartsetting2.h \
            chartwidget.h \
            chartwindow.h \
+           computesupport.h \
+           curvecache.h \
            datacalculate.h \
            datacolumndialog.h \
            dataimportdialog.h \
            datasinglesheet.h \
+           deconvolution.h \
+           differentialevolution.h \
+           dualnumber.h \
            fittingdatadialog.h \
            fittingpage.h \
            fittingparameterchart.h \
+           laplaceinversion.h \
+           levenbergmarquardt.h \
            modelmanager.h \
            modelparameter.h \
            modelselect.h \
            modelsolver01-06.h \
            mousezoom.h \
+           multistartfit.h \
            newprojectdialog.h \
            paramselectdialog.h \
            mainwindow.h \
@@ -78,8 +87,11 @@ HEADERS += \
            plottingdialog4.h \
            pressurederivativecalculator.h \
            pressurederivativecalculator1.h \
+           ratesuperposition.h \
            settingswidget.h \
            qcustomplot.h \
+           typecurvelibrary.h \
+           typecurvematch.h \
            wt_datawidget.h \
            wt_fittingwidget.h \
            wt_modelwidget.h \
@@ -116,22 +128,30 @@ FORMS += \
          wt_projectwidget.ui
 
 SOURCES += \
+           besselfunctions.cpp \
            chartsetting1.cpp \
            chartsetting2.cpp \
            chartwidget.cpp \
            chartwindow.cpp \
+           computesupport.cpp \
+           curvecache.cpp \
            datacalculate.cpp \
            datacolumndialog.cpp \
            dataimportdialog.cpp \
            datasinglesheet.cpp \
+           deconvolution.cpp \
+           differentialevolution.cpp \
            fittingdatadialog.cpp \
            fittingpage.cpp \
            fittingparameterchart.cpp \
+           laplaceinversion.cpp \
+           levenbergmarquardt.cpp \
            modelmanager.cpp \
            modelparameter.cpp \
            modelselect.cpp \
            modelsolver01-06.cpp \
            mousezoom.cpp \
+           multistartfit.cpp \
            newprojectdialog.cpp \
            paramselectdialog.cpp \
            main.cpp \
@@ -145,8 +165,11 @@ SOURCES += \
            plottingdialog4.cpp \
            pressurederivativecalculator.cpp \
            pressurederivativecalculator1.cpp \
+           ratesuperposition.cpp \
            settingswidget.cpp \
            qcustomplot.cpp \
+           typecurvelibrary.cpp \
+           typecurvematch.cpp \
            wt_datawidget.cpp \
            wt_fittingwidget.cpp \
            wt_modelwidget.cpp \
@@ -0,0 +1,689 @@
+/*
+ * 文件名: besselfunctions.cpp
+ * 文件作用: 修正贝塞尔函数计算工具实现
+ * 功能描述:
+ * 1. 实数版本使用分段 Chebyshev 展开 (系数以 50 位精度按 Boost 结果拟合)：
+ *    x <= 2 时 K0/K1 展开为 x^2 的光滑函数并扣除对数项，x > 2 时展开 K*e^x*sqrt(x)；
+ *    x <= 8 时展开 I*e^-x，x > 8 时展开 I*e^-x*sqrt(x)。全程相对误差约 1e-15。
+ * 2. 批量接口在支持 AVX2/FMA 的处理器上 (运行时检测) 每次计算 4 个参数的 Chebyshev 级数，
+ *    否则退回逐点标量计算。Boost 仅用于精度校验 (verifyAgainstBoost)。
+ * 3. 复数版本: |x|<=2 时使用幂级数；2<|x|<17 时使用 Steed 连分式 (CF2) 求 K0/K1，
+ *    再通过 I1/I0 连分式与 Wronskian 关系 I0*K1 + I1*K0 = 1/x 求 I0、I1；
+ *    |x|>=17 时使用 Hankel 渐近展开 (I 函数包含指数小量修正项)。
+ */
+
+#include "besselfunctions.h"
+
+#include <boost/math/special_functions/bessel.hpp>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  if defined(__GNUC__) || defined(__clang__)
+#    define BESSEL_HAS_AVX2 1
+#    define BESSEL_AVX2_TARGET __attribute__((target("avx2,fma")))
+#    include <immintrin.h>
+#  elif defined(_MSC_VER)
+#    define BESSEL_HAS_AVX2 1
+#    define BESSEL_AVX2_TARGET
+#    include <immintrin.h>
+#    include <intrin.h>
+#  endif
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+const double kEuler = 0.57721566490153286061;   // 欧拉常数
+const double kEps = 1e-16;
+const int kMaxIter = 20000;
+const double kAsymptotic = 17.0;   // 渐近展开的起始模长
+
+// |z|^2，避免 std::abs 内部的 hypot 调用 (迭代收敛判断使用)
+inline double norm2(const std::complex<double>& z)
+{
+    return z.real() * z.real() + z.imag() * z.imag();
+}
+
+// 实数 Chebyshev 展开系数: f(t) = sum c_k T_k(t)，t 属于 [-1, 1]
+// K0(x) + ln(x/2)*I0(x)，t = x^2/2 - 1 (0 < x <= 2)
+const double kK0Small[10] = {
+    -2.67663696616951384e-01,
+    3.44289899924628487e-01,
+    3.59799365153615016e-02,
+    1.26461541144692592e-03,
+    2.28621210311945179e-05,
+    2.53479107902614946e-07,
+    1.90451637722020886e-09,
+    1.03496952576336246e-11,
+    4.25981614279108258e-14,
+    1.37446543588075090e-16
+};
+
+// x*K1(x) - x*ln(x/2)*I1(x)，t = x^2/2 - 1 (0 < x <= 2)
+const double kK1Small[11] = {
+    7.62650113669473885e-01,
+    -3.53155960776544876e-01,
+    -1.22611180822657148e-01,
+    -6.97572385963986435e-03,
+    -1.73028895751305206e-04,
+    -2.43340614156596823e-06,
+    -2.21338763073472586e-08,
+    -1.41148839263352776e-10,
+    -6.66690169419932901e-13,
+    -2.42744985051936593e-15,
+    -7.02386347938628760e-18
+};
+
+// K0(x)*e^x*sqrt(x)，t = 4/x - 1 (x > 2)
+const double kK0Large[25] = {
+    1.22015154103297773e+00,
+    -3.14481013119645005e-02,
+    1.56988388573005337e-03,
+    -1.28495495816278026e-04,
+    1.39498137188764994e-05,
+    -1.83175552271911948e-06,
+    2.76681363944501508e-07,
+    -4.66048989768794767e-08,
+    8.57403401741422609e-09,
+    -1.69753450938906152e-09,
+    3.57739728140032845e-10,
+    -7.95748924447739704e-11,
+    1.85594911495492655e-11,
+    -4.51459788337451918e-12,
+    1.14034058820734423e-12,
+    -2.98009692314817835e-13,
+    8.03289077506837437e-14,
+    -2.22751332674629636e-14,
+    6.34007647627664597e-15,
+    -1.84859337792090717e-15,
+    5.51205599940433336e-16,
+    -1.67823112575490064e-16,
+    5.21039177764355411e-17,
+    -1.64758059398426328e-17,
+    5.30043377117733577e-18
+};
+
+// K1(x)*e^x*sqrt(x)，t = 4/x - 1 (x > 2)
+const double kK1Large[25] = {
+    1.36031309524222133e+00,
+    1.03923736576817238e-01,
+    -2.85781685962277939e-03,
+    1.95215518471351631e-04,
+    -1.93619797416608296e-05,
+    2.40648494783721712e-06,
+    -3.50196060308781254e-07,
+    5.74108412545004929e-08,
+    -1.03457624656780970e-08,
+    2.01504975519703462e-09,
+    -4.19035475934192558e-10,
+    9.21831518760531413e-11,
+    -2.12996783842779102e-11,
+    5.13963967348234354e-12,
+    -1.28917396094982294e-12,
+    3.34841966605224312e-13,
+    -8.97670518201014607e-14,
+    2.47715442421959868e-14,
+    -7.01983708921476885e-15,
+    2.03870316623986088e-15,
+    -6.05704727064301782e-16,
+    1.83809357524304543e-16,
+    -5.68946284919364837e-17,
+    1.79405104788635729e-17,
+    -5.75674448207330245e-18
+};
+
+// I0(x)*e^-x，t = x/4 - 1 (0 <= x <= 8)
+const double kI0Small[30] = {
+    3.38397637204738042e-01,
+    -3.04682672343198399e-01,
+    1.71620901522208775e-01,
+    -9.49010970480476444e-02,
+    4.93052842396707085e-02,
+    -2.37374148058994688e-02,
+    1.05464603945949983e-02,
+    -4.32430999505057594e-03,
+    1.63947561694133580e-03,
+    -5.76375574538582366e-04,
+    1.88502885095841656e-04,
+    -5.75419501008210370e-05,
+    1.64484480707288971e-05,
+    -4.41673835845875056e-06,
+    1.11738753912010372e-06,
+    -2.67079385394061173e-07,
+    6.04699502254191895e-08,
+    -1.30002500998624804e-08,
+    2.65982372468238665e-09,
+    -5.18979560163526291e-10,
+    9.67580903537323691e-11,
+    -1.72682629144155571e-11,
+    2.95505266312963983e-12,
+    -4.85644678311192946e-13,
+    7.67618549860493562e-14,
+    -1.16853328779934517e-14,
+    1.71539128555513303e-15,
+    -2.43127984654795469e-16,
+    3.33079451882223810e-17,
+    -4.41534164647933938e-18
+};
+
+// I1(x)*e^-x / x，t = x/4 - 1 (0 <= x <= 8)
+const double kI1Small[30] = {
+    1.26293593221816827e-01,
+    -1.76416518357834055e-01,
+    1.02643658689847095e-01,
+    -5.29459812080949914e-02,
+    2.47264490306265168e-02,
+    -1.05640848946261982e-02,
+    4.15642294431288816e-03,
+    -1.51357245063125315e-03,
+    5.12285956168575773e-04,
+    -1.61760815825896746e-04,
+    4.78156510755005423e-05,
+    -1.32731636560394358e-05,
+    3.47025130813767848e-06,
+    -8.56872026469545474e-07,
+    2.00329475355213526e-07,
+    -4.44505912879632808e-08,
+    9.38153738649577178e-09,
+    -1.88724975172282929e-09,
+    3.62559028155211704e-10,
+    -6.66348972350202774e-11,
+    1.17361862988909016e-11,
+    -1.98397439776494372e-12,
+    3.22379336594557471e-13,
+    -5.04218550472791169e-14,
+    7.60068429473540693e-15,
+    -1.10559694773538631e-15,
+    1.55363195773620047e-16,
+    -2.11142121435816608e-17,
+    2.77791411276104637e-18,
+    -3.54158177254213621e-19
+};
+
+// I0(x)*e^-x*sqrt(x)，t = 16/x - 1 (x > 8)
+const double kI0Large[27] = {
+    4.02245205507054416e-01,
+    3.36911647825569409e-03,
+    6.88975834691682398e-05,
+    2.89137052083475648e-06,
+    2.04891858946906374e-07,
+    2.26666899049817806e-08,
+    3.39623202570838635e-09,
+    4.94060238822496959e-10,
+    1.18891471078464383e-11,
+    -3.14991652796324136e-11,
+    -1.32158118404477131e-11,
+    -1.79417853150680612e-12,
+    7.18012445138366623e-13,
+    3.85277838274214270e-13,
+    1.54008621752140983e-14,
+    -4.15056934728722209e-14,
+    -9.55484669882830765e-15,
+    3.81168066935262242e-15,
+    1.77256013305652638e-15,
+    -3.42548561967721913e-16,
+    -2.82762398051658348e-16,
+    3.46122286769746109e-17,
+    4.46562142029676000e-17,
+    -4.83050448594418207e-18,
+    -7.23318048787475395e-18,
+    9.92147541217369860e-19,
+    1.19365089084598209e-18
+};
+
+// I1(x)*e^-x*sqrt(x)，t = 16/x - 1 (x > 8)
+const double kI1Large[27] = {
+    3.89288117509140060e-01,
+    -9.76109749136146841e-03,
+    -1.10588938762623716e-04,
+    -3.88256480887769039e-06,
+    -2.51223623787020893e-07,
+    -2.63146884688951951e-08,
+    -3.83538038596423702e-09,
+    -5.58974346219658381e-10,
+    -1.89749581235054123e-11,
+    3.25260358301548824e-11,
+    1.41258074366137813e-11,
+    2.03562854414708951e-12,
+    -7.19855177624590851e-13,
+    -4.08355111109219732e-13,
+    -2.10154184277266431e-14,
+    4.27244001671195135e-14,
+    1.04202769841288028e-14,
+    -3.81440307243700780e-15,
+    -1.88035477551078245e-15,
+    3.30820231092092828e-16,
+    2.96262899764595014e-16,
+    -3.20952592199342396e-17,
+    -4.65030536848935833e-17,
+    4.41434832307170795e-18,
+    7.51729631084210481e-18,
+    -9.31417886732688338e-19,
+    -1.24219327519489096e-18
+};
+
+// Clenshaw 递推求 Chebyshev 级数
+template<int N>
+inline double chebyshev(const double (&c)[N], double t)
+{
+    double b1 = 0.0, b2 = 0.0;
+    const double t2 = 2.0 * t;
+    for (int k = N - 1; k >= 1; --k) {
+        double b0 = t2 * b1 - b2 + c[k];
+        b2 = b1;
+        b1 = b0;
+    }
+    return t * b1 - b2 + c[0];
+}
+
+// 实数参数的标量计算 (x > 0；I 函数取 |x|)
+void evaluateReal(double x, double* k0, double* k1, double* i0e, double* i1e)
+{
+    const double ax = std::abs(x);
+    const bool needK = (k0 || k1);
+    double vi0e = 0.0, vi1e = 0.0;
+
+    // x <= 2 时 K0、K1 的对数项分别需要 I0、I1
+    const bool small = (ax <= 2.0);
+    const bool needI0 = i0e || (k0 && small);
+    const bool needI1 = i1e || (k1 && small);
+    if (needI0 || needI1) {
+        if (ax <= 8.0) {
+            double t = 0.25 * ax - 1.0;
+            if (needI0) vi0e = chebyshev(kI0Small, t);
+            if (needI1) vi1e = ax * chebyshev(kI1Small, t);
+        } else {
+            double t = 16.0 / ax - 1.0;
+            double r = 1.0 / std::sqrt(ax);
+            if (needI0) vi0e = chebyshev(kI0Large, t) * r;
+            if (needI1) vi1e = chebyshev(kI1Large, t) * r;
+        }
+        if (i0e) *i0e = vi0e;
+        if (i1e) *i1e = vi1e;
+    }
+    if (!needK) return;
+
+    if (x <= 0.0) {
+        if (k0) *k0 = std::numeric_limits<double>::infinity();
+        if (k1) *k1 = std::numeric_limits<double>::infinity();
+    } else if (x <= 2.0) {
+        double u = 0.5 * x * x - 1.0;
+        double lnh = std::log(0.5 * x);
+        double ex = std::exp(x);
+        if (k0) *k0 = chebyshev(kK0Small, u) - lnh * vi0e * ex;
+        if (k1) *k1 = chebyshev(kK1Small, u) / x + lnh * vi1e * ex;
+    } else {
+        double t = 4.0 / x - 1.0;
+        double s = std::exp(-x) / std::sqrt(x);
+        if (k0) *k0 = chebyshev(kK0Large, t) * s;
+        if (k1) *k1 = chebyshev(kK1Large, t) * s;
+    }
+}
+
+#ifdef BESSEL_HAS_AVX2
+// 运行时检测 AVX2 与 FMA (同时确认操作系统保存 YMM 寄存器)
+bool detectAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || !avx || !fma) return false;
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+bool g_simdEnabled = true;
+
+template<int N>
+BESSEL_AVX2_TARGET inline __m256d chebyshev4(const double (&c)[N], __m256d t)
+{
+    const __m256d t2 = _mm256_add_pd(t, t);
+    __m256d b1 = _mm256_setzero_pd(), b2 = _mm256_setzero_pd();
+    for (int k = N - 1; k >= 1; --k) {
+        __m256d b0 = _mm256_add_pd(_mm256_fmsub_pd(t2, b1, b2), _mm256_set1_pd(c[k]));
+        b2 = b1;
+        b1 = b0;
+    }
+    return _mm256_add_pd(_mm256_fmsub_pd(t, b1, b2), _mm256_set1_pd(c[0]));
+}
+
+// 4 个参数处于同一区间 (region: 0 为 x<=2，1 为 2<x<=8，2 为 x>8) 时的向量化计算
+// Chebyshev 级数、sqrt 与除法按 4 路并行；exp/log 逐路调用标准库
+BESSEL_AVX2_TARGET void evaluate4(const double* xp, int region, double* k0, double* k1, double* i0e, double* i1e)
+{
+    const __m256d x = _mm256_loadu_pd(xp);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const bool needI0 = i0e || (k0 && region == 0);
+    const bool needI1 = i1e || (k1 && region == 0);
+    __m256d vi0e = _mm256_setzero_pd(), vi1e = _mm256_setzero_pd();
+    if (region <= 1) {
+        __m256d t = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(0.25), x), one);
+        if (needI0) vi0e = chebyshev4(kI0Small, t);
+        if (needI1) vi1e = _mm256_mul_pd(x, chebyshev4(kI1Small, t));
+    } else {
+        __m256d t = _mm256_sub_pd(_mm256_div_pd(_mm256_set1_pd(16.0), x), one);
+        __m256d r = _mm256_div_pd(one, _mm256_sqrt_pd(x));
+        if (needI0) vi0e = _mm256_mul_pd(chebyshev4(kI0Large, t), r);
+        if (needI1) vi1e = _mm256_mul_pd(chebyshev4(kI1Large, t), r);
+    }
+    if (i0e) _mm256_storeu_pd(i0e, vi0e);
+    if (i1e) _mm256_storeu_pd(i1e, vi1e);
+    if (!k0 && !k1) return;
+
+    alignas(32) double xs[4], e[4], l[4];
+    _mm256_store_pd(xs, x);
+    if (region == 0) {
+        for (int j = 0; j < 4; ++j) { e[j] = std::exp(xs[j]); l[j] = std::log(0.5 * xs[j]); }
+        __m256d ex = _mm256_load_pd(e), lnh = _mm256_load_pd(l);
+        __m256d u = _mm256_fmsub_pd(_mm256_set1_pd(0.5), _mm256_mul_pd(x, x), one);
+        __m256d lnhEx = _mm256_mul_pd(lnh, ex);
+        if (k0) _mm256_storeu_pd(k0, _mm256_fnmadd_pd(lnhEx, vi0e, chebyshev4(kK0Small, u)));
+        if (k1) _mm256_storeu_pd(k1, _mm256_fmadd_pd(lnhEx, vi1e, _mm256_div_pd(chebyshev4(kK1Small, u), x)));
+    } else {
+        for (int j = 0; j < 4; ++j) e[j] = std::exp(-xs[j]);
+        __m256d s = _mm256_div_pd(_mm256_load_pd(e), _mm256_sqrt_pd(x));
+        __m256d t = _mm256_sub_pd(_mm256_div_pd(_mm256_set1_pd(4.0), x), one);
+        if (k0) _mm256_storeu_pd(k0, _mm256_mul_pd(chebyshev4(kK0Large, t), s));
+        if (k1) _mm256_storeu_pd(k1, _mm256_mul_pd(chebyshev4(kK1Large, t), s));
+    }
+}
+#endif
+
+inline int regionOf(double x)
+{
+    return (x <= 2.0) ? 0 : (x <= 8.0 ? 1 : 2);
+}
+
+inline double* offset(double* p, int i)
+{
+    return p ? p + i : nullptr;
+}
+
+inline std::complex<double>* offset(std::complex<double>* p, int i)
+{
+    return p ? p + i : nullptr;
+}
+}
+
+double BesselFunctions::k0(double x)
+{
+    double r;
+    evaluateReal(x, &r, nullptr, nullptr, nullptr);
+    return r;
+}
+
+double BesselFunctions::k1(double x)
+{
+    double r;
+    evaluateReal(x, nullptr, &r, nullptr, nullptr);
+    return r;
+}
+
+double BesselFunctions::i0e(double x)
+{
+    double r;
+    evaluateReal(x, nullptr, nullptr, &r, nullptr);
+    return r;
+}
+
+double BesselFunctions::i1e(double x)
+{
+    double r;
+    evaluateReal(x, nullptr, nullptr, nullptr, &r);
+    return r;
+}
+
+std::complex<double> BesselFunctions::k0(const std::complex<double>& x)
+{
+    std::complex<double> r;
+    evaluate(x, &r, nullptr, nullptr, nullptr);
+    return r;
+}
+
+std::complex<double> BesselFunctions::k1(const std::complex<double>& x)
+{
+    std::complex<double> r;
+    evaluate(x, nullptr, &r, nullptr, nullptr);
+    return r;
+}
+
+std::complex<double> BesselFunctions::i0e(const std::complex<double>& x)
+{
+    std::complex<double> r;
+    evaluate(x, nullptr, nullptr, &r, nullptr);
+    return r;
+}
+
+std::complex<double> BesselFunctions::i1e(const std::complex<double>& x)
+{
+    std::complex<double> r;
+    evaluate(x, nullptr, nullptr, nullptr, &r);
+    return r;
+}
+
+void BesselFunctions::evaluate(double x, double* k0, double* k1, double* i0e, double* i1e)
+{
+    evaluateReal(x, k0, k1, i0e, i1e);
+}
+
+void BesselFunctions::evaluate(const double* x, int n, double* k0, double* k1, double* i0e, double* i1e)
+{
+    int i = 0;
+#ifdef BESSEL_HAS_AVX2
+    if (simdAvailable() && g_simdEnabled) {
+        for (; i + 4 <= n; i += 4) {
+            const int region = regionOf(x[i]);
+            if (x[i] > 0.0 && x[i + 1] > 0.0 && x[i + 2] > 0.0 && x[i + 3] > 0.0
+                && regionOf(x[i + 1]) == region && regionOf(x[i + 2]) == region && regionOf(x[i + 3]) == region) {
+                evaluate4(x + i, region, offset(k0, i), offset(k1, i), offset(i0e, i), offset(i1e, i));
+            } else {
+                for (int j = i; j < i + 4; ++j)
+                    evaluateReal(x[j], offset(k0, j), offset(k1, j), offset(i0e, j), offset(i1e, j));
+            }
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        evaluateReal(x[i], offset(k0, i), offset(k1, i), offset(i0e, i), offset(i1e, i));
+    }
+}
+
+void BesselFunctions::evaluate(const std::complex<double>* x, int n,
+                               std::complex<double>* k0, std::complex<double>* k1,
+                               std::complex<double>* i0e, std::complex<double>* i1e)
+{
+    for (int i = 0; i < n; ++i) {
+        evaluate(x[i], offset(k0, i), offset(k1, i), offset(i0e, i), offset(i1e, i));
+    }
+}
+
+bool BesselFunctions::simdAvailable()
+{
+#ifdef BESSEL_HAS_AVX2
+    static const bool available = detectAvx2();
+    return available;
+#else
+    return false;
+#endif
+}
+
+void BesselFunctions::setSimdEnabled(bool enabled)
+{
+#ifdef BESSEL_HAS_AVX2
+    g_simdEnabled = enabled;
+#else
+    (void)enabled;
+#endif
+}
+
+BesselFunctions::AccuracyReport BesselFunctions::verifyAgainstBoost(double xMin, double xMax, int samples)
+{
+    AccuracyReport rep;
+    if (samples < 2 || xMin <= 0.0 || xMax <= xMin) return rep;
+
+    // 对数等距取样，批量接口计算 (可用时走 AVX2 路径)
+    std::vector<double> x(samples), k0v(samples), k1v(samples), i0v(samples), i1v(samples);
+    const double ratio = std::log(xMax / xMin) / (samples - 1);
+    for (int i = 0; i < samples; ++i) x[i] = xMin * std::exp(ratio * i);
+    evaluate(x.data(), samples, k0v.data(), k1v.data(), i0v.data(), i1v.data());
+
+    auto track = [](double value, double ref, double arg, double& maxErr, double& worst) {
+        if (ref == 0.0 || !std::isfinite(ref)) return;
+        double err = std::abs(value - ref) / std::abs(ref);
+        if (!(err <= maxErr)) { maxErr = err; worst = arg; }
+    };
+    for (int i = 0; i < samples; ++i) {
+        const double xi = x[i];
+        track(k0v[i], boost::math::cyl_bessel_k(0, xi), xi, rep.maxRelErrorK0, rep.worstArgK0);
+        track(k1v[i], boost::math::cyl_bessel_k(1, xi), xi, rep.maxRelErrorK1, rep.worstArgK1);
+        // I 函数在 x > 700 时溢出，以 Boost 的指数缩放结果为参照
+        double ref0 = (xi < 700.0) ? boost::math::cyl_bessel_i(0, xi) * std::exp(-xi) : std::numeric_limits<double>::quiet_NaN();
+        double ref1 = (xi < 700.0) ? boost::math::cyl_bessel_i(1, xi) * std::exp(-xi) : std::numeric_limits<double>::quiet_NaN();
+        track(i0v[i], ref0, xi, rep.maxRelErrorI0e, rep.worstArgI0e);
+        track(i1v[i], ref1, xi, rep.maxRelErrorI1e, rep.worstArgI1e);
+    }
+    rep.samples = samples;
+    rep.simdUsed = simdAvailable()
+#ifdef BESSEL_HAS_AVX2
+                   && g_simdEnabled
+#endif
+                   ;
+    return rep;
+}
+
+void BesselFunctions::evaluate(const std::complex<double>& x,
+                               std::complex<double>* k0, std::complex<double>* k1,
+                               std::complex<double>* i0s, std::complex<double>* i1s)
+{
+    using cd = std::complex<double>;
+    const double absX = std::abs(x);
+
+    if (absX <= 2.0) {
+        // 幂级数: I0 = sum y^k/(k!)^2, I1 = x/2 * sum y^k/(k!(k+1)!), y = x^2/4
+        cd y = 0.25 * x * x;
+        cd termI0(1.0, 0.0), termI1(1.0, 0.0);
+        cd sumI0(1.0, 0.0), sumI1(1.0, 0.0), sumK0(0.0, 0.0);
+        double harmonic = 0.0;
+        for (int k = 1; k < 60; ++k) {
+            harmonic += 1.0 / k;
+            termI0 *= y / double(k * k);
+            termI1 *= y / double(k * (k + 1));
+            sumI0 += termI0;
+            sumI1 += termI1;
+            sumK0 += termI0 * harmonic;
+            if (norm2(termI0) < kEps * kEps * norm2(sumI0)) break;
+        }
+        cd I0 = sumI0;
+        cd I1 = 0.5 * x * sumI1;
+        cd K0 = -(std::log(0.5 * x) + kEuler) * I0 + sumK0;
+        cd K1 = (1.0 / x - I1 * K0) / I0;   // Wronskian
+        cd ex = std::exp(-x);
+        if (k0) *k0 = K0;
+        if (k1) *k1 = K1;
+        if (i0s) *i0s = I0 * ex;
+        if (i1s) *i1s = I1 * ex;
+        return;
+    }
+
+    if (absX >= kAsymptotic) {
+        // K_v(x)e^x ~ sqrt(pi/2x) sum a_k(v)/x^k,  I_v(x)e^-x ~ 1/sqrt(2pi x) sum (-1)^k a_k(v)/x^k + 指数小量
+        // a_k(v) = (4v^2-1)(4v^2-9)...(4v^2-(2k-1)^2) / (k! 8^k)
+        cd xi = 1.0 / x;
+        cd sumK0(1.0, 0.0), sumK1(1.0, 0.0), sumI0(1.0, 0.0), sumI1(1.0, 0.0);
+        cd t0(1.0, 0.0), t1(1.0, 0.0);
+        double prev = 1.0;
+        for (int k = 1; k < 60; ++k) {
+            double odd = (2.0 * k - 1.0) * (2.0 * k - 1.0);
+            t0 *= (0.0 - odd) / (8.0 * k) * xi;
+            t1 *= (4.0 - odd) / (8.0 * k) * xi;
+            double mag = norm2(t0) + norm2(t1);
+            if (mag > prev) break;   // 渐近级数开始发散
+            double sign = (k % 2 == 0) ? 1.0 : -1.0;
+            sumK0 += t0; sumK1 += t1;
+            sumI0 += sign * t0; sumI1 += sign * t1;
+            prev = mag;
+            if (mag < kEps * kEps) break;
+        }
+        cd root = std::sqrt(x);
+        cd k0e = std::sqrt(M_PI / 2.0) / root * sumK0;
+        cd k1e = std::sqrt(M_PI / 2.0) / root * sumK1;
+        if (k0) *k0 = k0e * std::exp(-x);
+        if (k1) *k1 = k1e * std::exp(-x);
+        if (i0s || i1s) {
+            // 指数小量修正 (DLMF 10.40.5): sigma*i*e^(sigma*i*v*pi) * e^-2x * K_v(x)e^x / pi
+            double sigma = (x.imag() < 0.0) ? -1.0 : 1.0;
+            cd corr = cd(0.0, sigma) * std::exp(-2.0 * x) / M_PI;
+            cd base = 1.0 / (std::sqrt(2.0 * M_PI) * root);
+            if (i0s) *i0s = base * sumI0 + corr * k0e;
+            if (i1s) *i1s = base * sumI1 - corr * k1e;
+        }
+        return;
+    }
+
+    // Steed 连分式 (CF2)，得到 K0*e^x、K1*e^x
+    cd b = 2.0 * (1.0 + x);
+    cd d = 1.0 / b;
+    cd h = d, delh = d;
+    cd q1(0.0, 0.0), q2(1.0, 0.0);
+    const double a1 = 0.25;
+    cd q(a1, 0.0), c(a1, 0.0);
+    double a = -a1;
+    cd s = 1.0 + q * delh;
+    for (int i = 2; i <= kMaxIter; ++i) {
+        a -= 2 * (i - 1);
+        c = -a * c / double(i);
+        cd qnew = (q1 - b * q2) / a;
+        q1 = q2;
+        q2 = qnew;
+        q += c * qnew;
+        b += 2.0;
+        d = 1.0 / (b + a * d);
+        delh = (b * d - 1.0) * delh;
+        h += delh;
+        cd dels = q * delh;
+        s += dels;
+        if (norm2(dels) < kEps * kEps * norm2(s)) break;
+    }
+    h = a1 * h;
+    cd k0e = std::sqrt(M_PI / (2.0 * x)) / s;
+    cd k1e = k0e * (x + 0.5 - h) / x;
+
+    if (k0) *k0 = k0e * std::exp(-x);
+    if (k1) *k1 = k1e * std::exp(-x);
+    if (!i0s && !i1s) return;
+
+    // I1/I0 = 1/(2/x + 1/(4/x + 1/(6/x + ...)))，修正 Lentz 算法
+    const double tiny = 1e-150;
+    cd xi = 1.0 / x;
+    cd f(tiny, 0.0), C = f, D(0.0, 0.0);
+    for (int n = 1; n <= kMaxIter; ++n) {
+        cd bn = 2.0 * n * xi;
+        D = bn + D;
+        if (norm2(D) < tiny * tiny) D = tiny;
+        C = bn + 1.0 / C;
+        if (norm2(C) < tiny * tiny) C = tiny;
+        D = 1.0 / D;
+        cd delta = C * D;
+        f *= delta;
+        if (norm2(delta - 1.0) < kEps * kEps) break;
+    }
+    cd ratio = f;
+    cd I0s = 1.0 / (x * (k1e + ratio * k0e));   // Wronskian
+    if (i0s) *i0s = I0s;
+    if (i1s) *i1s = ratio * I0s;
+}
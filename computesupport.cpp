@@ -0,0 +1,37 @@
+/*
+ * 文件名: computesupport.cpp
+ * 文件作用: 数值计算公共工具实现文件
+ * 功能描述:
+ * 1. 各环节的线程池为函数内静态对象，首次使用时创建；最大线程数只增不减。
+ * 2. Catmull-Rom 插值的 Hermite 基函数展开。
+ */
+
+#include "computesupport.h"
+
+#include <QThreadPool>
+#include <cmath>
+
+QThreadPool* ComputeSupport::pool(Pool which, int threads)
+{
+    static QThreadPool pools[PoolCount];
+    QThreadPool* p = &pools[which];
+    if (p->maxThreadCount() < threads) p->setMaxThreadCount(threads);
+    return p;
+}
+
+double ComputeSupport::catmullRom(double y0, double y1, double y2, double y3, double s)
+{
+    const double m1 = 0.5 * (y2 - y0);
+    const double m2 = 0.5 * (y3 - y1);
+    const double s2 = s * s, s3 = s2 * s;
+    return (2.0 * s3 - 3.0 * s2 + 1.0) * y1 + (s3 - 2.0 * s2 + s) * m1
+         + (-2.0 * s3 + 3.0 * s2) * y2 + (s3 - s2) * m2;
+}
+
+double ComputeSupport::interpolateLogLog(double y0, double y1, double y2, double y3, double s)
+{
+    if (y0 > 0.0 && y1 > 0.0 && y2 > 0.0 && y3 > 0.0) {
+        return std::exp(catmullRom(std::log(y0), std::log(y1), std::log(y2), std::log(y3), s));
+    }
+    return y1 + s * (y2 - y1);
+}
@@ -0,0 +1,40 @@
+/*
+ * 文件名: computesupport.h
+ * 文件作用: 数值计算公共工具头文件
+ * 功能描述:
+ * 1. 专用线程池: 每个并行计算环节 (反演取样、叠加、反褶积、多起点、差分进化、差分 Jacobian) 各用一个独立线程池。
+ *    拟合线程运行在全局线程池中，上层任务 (如多起点的一个起点) 阻塞等待下层环节的 blockingMap 时，
+ *    下层任务若与上层共用线程池就可能因线程被占满而相互等待；各环节分开后只会等待更下层的线程池。
+ * 2. 双对数坐标下的 Catmull-Rom 插值 (主曲线缓存、单位产量响应表、类型曲线库共用)。
+ */
+
+#ifndef COMPUTESUPPORT_H
+#define COMPUTESUPPORT_H
+
+class QThreadPool;
+
+class ComputeSupport
+{
+public:
+    // 专用线程池 (按调用层次从下到上排列)
+    enum Pool {
+        InversionPool = 0,      // 拉普拉斯反演取样
+        SuperpositionPool,      // 变产量叠加
+        DeconvolutionPool,      // 反褶积法方程组装
+        JacobianPool,           // 差分 Jacobian 的扰动曲线
+        MultiStartPool,         // 多起点全局拟合的起点
+        EvolutionPool,          // 差分进化一代的试验个体
+        PoolCount
+    };
+
+    // 返回指定环节的线程池，最大线程数不少于 threads (0 表示保持默认的 QThread::idealThreadCount())
+    static QThreadPool* pool(Pool which, int threads = 0);
+
+    // 三次 Hermite 插值 (Catmull-Rom 斜率)：s 为 y1 到 y2 之间的位置
+    static double catmullRom(double y0, double y1, double y2, double y3, double s);
+
+    // 双对数坐标下的 Catmull-Rom 插值 (对 ln y 插值)，模板中有非正值时退化为线性插值
+    static double interpolateLogLog(double y0, double y1, double y2, double y3, double s);
+};
+
+#endif // COMPUTESUPPORT_H
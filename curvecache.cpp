@@ -0,0 +1,128 @@
+/*
+ * 文件名: curvecache.cpp
+ * 文件作用: 理论曲线结果缓存 (进程内 LRU) 实现文件
+ * 功能描述:
+ * 1. 基于 QCache 实现按字节计费的 LRU 淘汰，外加互斥锁保证线程安全。
+ * 2. 哈希 (含求解器设置) 仅定位条目，命中前逐项核对参数、时间序列与求解器设置。
+ * 3. 统计命中率、淘汰次数与当前占用，供界面或日志查看缓存效果。
+ */
+
+#include "curvecache.h"
+
+#include <QHashFunctions>
+
+size_t qHash(const CurveCache::Key& key, size_t seed) noexcept
+{
+    return qHashMulti(seed, key.model, key.params, key.time, key.settings);
+}
+
+CurveCache::CurveCache(qint64 maxBytes)
+{
+    m_entries.setMaxCost(qMax<qint64>(0, maxBytes));
+}
+
+size_t CurveCache::hashParameters(const QMap<QString, double>& params, size_t seed)
+{
+    size_t h = seed;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        // qHash(double) 已将 -0.0 与 0.0 视为相同
+        h = qHashMulti(h, it.key(), it.value());
+    }
+    return h;
+}
+
+size_t CurveCache::hashTimes(const QVector<double>& time, size_t seed)
+{
+    return qHashRange(time.constBegin(), time.constEnd(), qHash(time.size(), seed));
+}
+
+CurveCache::Key CurveCache::makeKey(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                                    const QVector<double>& settings)
+{
+    Key key;
+    key.model = model;
+    key.params = hashParameters(params);
+    key.time = hashTimes(time);
+    key.settings = qHashRange(settings.constBegin(), settings.constEnd(), 0);
+    return key;
+}
+
+// 条目占用: 曲线三列与时间序列的数据量，加上参数表与容器的固定开销 (估算)
+qint64 CurveCache::entryBytes(const Entry& entry)
+{
+    const qint64 curvePoints = std::get<0>(entry.curve).size() + std::get<1>(entry.curve).size()
+                             + std::get<2>(entry.curve).size();
+    const qint64 values = curvePoints + entry.time.size() + entry.settings.size();
+    return qint64(sizeof(double)) * values + 64 * qint64(entry.params.size()) + 256;
+}
+
+bool CurveCache::lookup(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                        const QVector<double>& settings, ModelCurveData* out)
+{
+    const Key key = makeKey(model, params, time, settings);
+
+    QMutexLocker locker(&m_mutex);
+    const Entry* entry = m_entries.object(key);   // 命中时移到最近使用端
+    if (entry && entry->params == params && entry->time == time && entry->settings == settings) {
+        ++m_stats.hits;
+        if (out) *out = entry->curve;
+        return true;
+    }
+    ++m_stats.misses;
+    return false;
+}
+
+void CurveCache::insert(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                        const QVector<double>& settings, const ModelCurveData& curve)
+{
+    Entry* entry = new Entry;
+    entry->params = params;
+    entry->time = time;
+    entry->settings = settings;
+    entry->curve = curve;
+    const qint64 cost = entryBytes(*entry);
+    const Key key = makeKey(model, params, time, settings);
+
+    QMutexLocker locker(&m_mutex);
+    const qsizetype before = m_entries.count() - (m_entries.contains(key) ? 1 : 0);
+    // QCache 在 cost 超过上限时直接删除 entry 并返回 false
+    if (!m_entries.insert(key, entry, cost)) return;
+    ++m_stats.insertions;
+    m_stats.evictions += qMax<qsizetype>(0, before + 1 - m_entries.count());
+}
+
+void CurveCache::setMaxBytes(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    const qsizetype before = m_entries.count();
+    m_entries.setMaxCost(qMax<qint64>(0, bytes));
+    m_stats.evictions += before - m_entries.count();
+}
+
+qint64 CurveCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.maxCost();
+}
+
+void CurveCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+CurveCache::Stats CurveCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats s = m_stats;
+    s.entries = int(m_entries.count());
+    s.bytes = m_entries.totalCost();
+    s.maxBytes = m_entries.maxCost();
+    return s;
+}
+
+void CurveCache::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats = Stats();
+}
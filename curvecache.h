@@ -0,0 +1,93 @@
+/*
+ * 文件名: curvecache.h
+ * 文件作用: 理论曲线结果缓存 (进程内 LRU) 头文件
+ * 功能描述:
+ * 1. 按 (模型类型, 参数表哈希, 时间序列哈希, 求解器设置哈希) 缓存 calculateTheoreticalCurve 的完整结果，
+ *    同一组参数再次请求 (切换页面、重置、加载项目、滚轮来回调整) 时直接返回，不再计算；
+ *    同一参数与时间序列在不同设置下的曲线 (拟合精度与显示精度) 是不同的条目，不会相互覆盖。
+ * 2. 哈希只用于定位，命中时再逐项比较参数表、时间序列与求解器设置，哈希冲突不会返回错误的曲线。
+ * 3. 按曲线占用的字节数计费，超过内存上限时淘汰最久未使用的条目。
+ * 4. 所有接口加锁，可在界面线程与拟合线程同时调用；记录命中、未命中、淘汰次数。
+ */
+
+#ifndef CURVECACHE_H
+#define CURVECACHE_H
+
+#include <QCache>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include "modelsolver01-06.h"
+
+class CurveCache
+{
+public:
+    // 默认内存上限 (字节)
+    static const qint64 kDefaultMaxBytes = 64 * 1024 * 1024;
+
+    // 统计信息
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 insertions = 0;
+        qint64 evictions = 0;   // 因超过内存上限被淘汰的条目数 (不含 clear)
+        int entries = 0;
+        qint64 bytes = 0;
+        qint64 maxBytes = 0;
+        double hitRate() const { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    explicit CurveCache(qint64 maxBytes = kDefaultMaxBytes);
+
+    // 查找: 命中时写入 out 并返回 true；settings 为求解器选项的 SolverOptions::key()
+    bool lookup(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                const QVector<double>& settings, ModelCurveData* out);
+
+    // 插入 (已有相同键时替换)；单条超过内存上限时不缓存
+    void insert(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                const QVector<double>& settings, const ModelCurveData& curve);
+
+    // 内存上限 (字节，0 为不缓存)；调小时立即淘汰
+    void setMaxBytes(qint64 bytes);
+    qint64 maxBytes() const;
+
+    void clear();
+    Stats stats() const;
+    void resetStats();
+
+    // 参数表的规范哈希: QMap 按参数名有序，-0.0 与 0.0 哈希相同
+    static size_t hashParameters(const QMap<QString, double>& params, size_t seed = 0);
+    static size_t hashTimes(const QVector<double>& time, size_t seed = 0);
+
+private:
+    struct Key {
+        int model = 0;
+        size_t params = 0;
+        size_t time = 0;
+        size_t settings = 0;
+        bool operator==(const Key& other) const
+        {
+            return model == other.model && params == other.params && time == other.time && settings == other.settings;
+        }
+    };
+    friend size_t qHash(const Key& key, size_t seed) noexcept;
+
+    struct Entry {
+        QMap<QString, double> params;
+        QVector<double> time;
+        QVector<double> settings;
+        ModelCurveData curve;
+    };
+
+    static Key makeKey(int model, const QMap<QString, double>& params, const QVector<double>& time,
+                       const QVector<double>& settings);
+    static qint64 entryBytes(const Entry& entry);
+
+private:
+    mutable QMutex m_mutex;
+    QCache<Key, Entry> m_entries;   // cost 为条目字节数
+    Stats m_stats;
+};
+
+#endif // CURVECACHE_H
@@ -0,0 +1,436 @@
+/*
+ * 文件名: deconvolution.cpp
+ * 文件作用: 压力-产量反褶积实现文件
+ * 功能描述:
+ * 1. 响应表: 分段线性 z 在每段上的积分有解析式，g 在节点处的值与各段积分对两端 z 的偏导预先算好，
+ *    任意 tau 的 g 及其偏导只需一次指数运算。
+ * 2. 法方程组装: 压力点按固定行数分块并行计算，每块内逐行生成 Jacobian 行并做秩更新，
+ *    各块结果按块序合并，结果与线程数无关；曲率正则算子为稀疏带状矩阵。
+ *    每行只对 RateSuperposition 给出的等效点源求和 (近处为各次产量变化，远处的组为插值矩)，
+ *    等效点源与 z 无关，模型对 z 的偏导仍为精确值。
+ * 3. Levenberg-Marquardt 迭代 (Marquardt 对角缩放)，试探步的目标函数非有限值时视为失败并加大阻尼。
+ */
+
+#include "deconvolution.h"
+#include "computesupport.h"
+#include "ratesuperposition.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 法方程按固定行数分块累加
+const int kChunkRows = 4096;
+// 每次秩更新包含的行数
+const int kBlockRows = 64;
+
+// phi1(x) = (e^x - 1)/x，phi2(x) = (e^x (x - 1) + 1)/x^2；|x| 较小时用 Taylor 展开避免相消
+void phiFunctions(double x, double& phi1, double& phi2)
+{
+    if (std::abs(x) < 1e-2) {
+        phi1 = 1.0 + x * (1.0 / 2.0 + x * (1.0 / 6.0 + x * (1.0 / 24.0 + x / 120.0)));
+        phi2 = 1.0 / 2.0 + x * (1.0 / 3.0 + x * (1.0 / 8.0 + x * (1.0 / 30.0 + x / 144.0)));
+    } else {
+        const double ex = std::exp(x);
+        phi1 = (ex - 1.0) / x;
+        phi2 = (ex * (x - 1.0) + 1.0) / (x * x);
+    }
+}
+
+// 分段线性 z(sigma) 对应的单位产量响应:
+// sigma <= sigma_0 时 g = e^{z_0} * e^{sigma - sigma_0} (单位斜率)，之后逐段累加 e^{z(sigma)} 的积分，
+// 最后一个节点之后 z 取常数
+class ResponseTable
+{
+public:
+    ResponseTable(int nodes, double sigma0, double step)
+        : m_nodes(nodes), m_sigma0(sigma0), m_step(step)
+        , m_ez(nodes), m_dz(nodes), m_full(nodes), m_fullB(nodes), m_value(nodes)
+    {
+    }
+
+    void update(const double* z)
+    {
+        for (int k = 0; k < m_nodes; ++k) m_ez[k] = std::exp(z[k]);
+        m_value[0] = m_ez[0];
+        for (int k = 0; k + 1 < m_nodes; ++k) {
+            double phi1, phi2;
+            m_dz[k] = z[k + 1] - z[k];
+            phiFunctions(m_dz[k], phi1, phi2);
+            m_full[k] = m_ez[k] * m_step * phi1;    // 整段积分
+            m_fullB[k] = m_ez[k] * m_step * phi2;   // 整段积分对 z_{k+1} 的偏导
+            m_value[k + 1] = m_value[k] + m_full[k];
+        }
+    }
+
+    // g(sigma)；row 非空时把 weight * dg/dz 的段内部分累加到 row，
+    // 所在段之前的整段部分只把 weight 累加到 segmentWeight[段号]，由 finishRow 一次展开
+    double evaluate(double sigma, double weight, double* row, double* segmentWeight) const
+    {
+        const double u = (sigma - m_sigma0) / m_step;
+        if (u <= 0.0) {
+            const double g = m_ez[0] * std::exp(sigma - m_sigma0);
+            if (row) row[0] += weight * g;
+            return g;
+        }
+        const int last = m_nodes - 1;
+        if (u >= last) {
+            const double s = sigma - (m_sigma0 + last * m_step);
+            if (row) {
+                segmentWeight[last] += weight;
+                row[last] += weight * m_ez[last] * s;
+            }
+            return m_value[last] + m_ez[last] * s;
+        }
+        const int m = std::min(int(u), last - 1);
+        const double s = sigma - (m_sigma0 + m * m_step);
+        double phi1, phi2;
+        phiFunctions(m_dz[m] * s / m_step, phi1, phi2);
+        const double partial = m_ez[m] * s * phi1;
+        if (row) {
+            const double dB = m_ez[m] * s * s * phi2 / m_step;
+            segmentWeight[m] += weight;
+            row[m] += weight * (partial - dB);
+            row[m + 1] += weight * dB;
+        }
+        return m_value[m] + partial;
+    }
+
+    // row += sum_m segmentWeight[m] * d(g(sigma_m))/dz，g(sigma_m) = e^{z_0} + sum_{k<m} 第 k 段整段积分
+    void finishRow(double* row, const double* segmentWeight) const
+    {
+        double suffix = 0.0;
+        for (int k = m_nodes - 2; k >= 0; --k) {
+            suffix += segmentWeight[k + 1];
+            row[k] += suffix * (m_full[k] - m_fullB[k]);
+            row[k + 1] += suffix * m_fullB[k];
+        }
+        row[0] += (suffix + segmentWeight[0]) * m_ez[0];
+    }
+
+    double value(int k) const { return m_value[k]; }
+    double logDerivative(int k) const { return m_ez[k]; }
+
+private:
+    int m_nodes;
+    double m_sigma0;
+    double m_step;
+    QVector<double> m_ez;       // e^{z_k}
+    QVector<double> m_dz;       // z_{k+1} - z_k
+    QVector<double> m_full;     // 第 k 段整段积分
+    QVector<double> m_fullB;    // 第 k 段整段积分对 z_{k+1} 的偏导 (对 z_k 的偏导为 m_full - m_fullB)
+    QVector<double> m_value;    // g(sigma_k)
+};
+
+// 参与反演的压力点与产量变化
+struct Problem {
+    QVector<double> time;
+    QVector<double> pressure;
+    QVector<int> source;            // 在输入压力记录中的下标
+    QVector<int> changes;           // 每个压力点之前的产量变化次数
+    QVector<double> changeTimes;
+    QVector<double> steps;          // 产量增量 q_j - q_{j-1}
+    QVector<double> levels;         // 各次变化之后的产量
+    const RateSuperposition* history = nullptr;     // 由 changeTimes 与 levels 构造的叠加树
+    int nodes = 0;
+    double sigma0 = 0.0;
+    double step = 1.0;
+    bool estimateP0 = true;
+    double fixedP0 = 0.0;
+
+    int unknowns() const { return nodes + (estimateP0 ? 1 : 0); }
+    double initialPressure(const Eigen::VectorXd& x) const { return estimateP0 ? x[nodes] : fixedP0; }
+};
+
+// 数据项: 返回残差平方和；normal 非空时同时累加 J^T J (下三角) 与 J^T r，fitted 非空时输出重构压力
+double assemble(const Problem& problem, const Eigen::VectorXd& x,
+                Eigen::MatrixXd* normal, Eigen::VectorXd* gradient, QVector<double>* fitted)
+{
+    const int np = problem.time.size();
+    const int nodes = problem.nodes;
+    const int unknowns = problem.unknowns();
+    const double p0 = problem.initialPressure(x);
+
+    ResponseTable table(nodes, problem.sigma0, problem.step);
+    table.update(x.data());
+
+    struct ChunkSum {
+        double sse = 0.0;
+        Eigen::MatrixXd normal;
+        Eigen::VectorXd gradient;
+    };
+    const int chunks = (np + kChunkRows - 1) / kChunkRows;
+    QVector<ChunkSum> sums(chunks);
+    if (fitted) fitted->resize(np);
+
+    auto runChunk = [&](int c) {
+        ChunkSum& sum = sums[c];
+        const int begin = c * kChunkRows;
+        const int end = std::min(np, begin + kChunkRows);
+        const bool withNormal = (normal != nullptr);
+        QVector<double> row(nodes), segmentWeight(nodes);
+        QVector<double> sourceTimes, sourceWeights;
+        Eigen::MatrixXd block;
+        Eigen::VectorXd residual;
+        int filled = 0;
+        if (withNormal) {
+            sum.normal = Eigen::MatrixXd::Zero(unknowns, unknowns);
+            sum.gradient = Eigen::VectorXd::Zero(unknowns);
+            block.resize(unknowns, kBlockRows);
+            residual.resize(kBlockRows);
+        }
+        auto flush = [&]() {
+            if (filled == 0) return;
+            const auto B = block.leftCols(filled);
+            sum.normal.selfadjointView<Eigen::Lower>().rankUpdate(B);
+            sum.gradient.noalias() += B * residual.head(filled);
+            filled = 0;
+        };
+
+        for (int i = begin; i < end; ++i) {
+            const double t = problem.time[i];
+            problem.history->sources(t, sourceTimes, sourceWeights);
+            const int count = sourceTimes.size();
+            double* rowData = nullptr;
+            double* weightData = nullptr;
+            if (withNormal) {
+                std::fill(row.begin(), row.end(), 0.0);
+                std::fill(segmentWeight.begin(), segmentWeight.end(), 0.0);
+                rowData = row.data();
+                weightData = segmentWeight.data();
+            }
+
+            double model = p0;
+            for (int j = 0; j < count; ++j) {
+                const double w = sourceWeights[j];
+                model -= w * table.evaluate(std::log(t - sourceTimes[j]), w, rowData, weightData);
+            }
+            const double r = model - problem.pressure[i];
+            sum.sse += r * r;
+            if (fitted) (*fitted)[i] = model;
+
+            if (withNormal) {
+                table.finishRow(rowData, weightData);
+                for (int k = 0; k < nodes; ++k) block(k, filled) = -rowData[k];
+                if (problem.estimateP0) block(nodes, filled) = 1.0;
+                residual[filled] = r;
+                if (++filled == kBlockRows) flush();
+            }
+        }
+        if (withNormal) flush();
+    };
+
+    const int threads = std::min(QThread::idealThreadCount(), chunks);
+    if (threads <= 1) {
+        for (int c = 0; c < chunks; ++c) runChunk(c);
+    } else {
+        QVector<int> tasks(chunks);
+        for (int c = 0; c < chunks; ++c) tasks[c] = c;
+        QtConcurrent::blockingMap(ComputeSupport::pool(ComputeSupport::DeconvolutionPool, threads), tasks, runChunk);
+    }
+
+    double sse = 0.0;
+    if (normal) {
+        normal->setZero(unknowns, unknowns);
+        gradient->setZero(unknowns);
+    }
+    for (const ChunkSum& sum : sums) {
+        sse += sum.sse;
+        if (normal) {
+            *normal += sum.normal;
+            *gradient += sum.gradient;
+        }
+    }
+    return sse;
+}
+}
+
+QVector<double> Deconvolution::changeTimesFromDurations(const QVector<double>& durations, double startTime)
+{
+    QVector<double> times(durations.size());
+    double t = startTime;
+    for (int j = 0; j < durations.size(); ++j) {
+        times[j] = t;
+        t += durations[j];
+    }
+    return times;
+}
+
+Deconvolution::Result Deconvolution::deconvolve(const QVector<double>& time, const QVector<double>& pressure,
+                                                const QVector<double>& changeTimes, const QVector<double>& rates)
+{
+    return deconvolve(time, pressure, changeTimes, rates, Settings());
+}
+
+Deconvolution::Result Deconvolution::deconvolve(const QVector<double>& time, const QVector<double>& pressure,
+                                                const QVector<double>& changeTimes, const QVector<double>& rates,
+                                                const Settings& settings)
+{
+    Result result;
+    Problem problem;
+
+    // 1. 产量历史: 只保留产量确有变化的时刻 (时刻须为升序)
+    const int nq = std::min(changeTimes.size(), rates.size());
+    double previous = 0.0;
+    double lastRate = 0.0;
+    for (int j = 0; j < nq; ++j) {
+        if (!std::isfinite(changeTimes[j]) || !std::isfinite(rates[j])) continue;
+        if (!problem.changeTimes.isEmpty() && changeTimes[j] < problem.changeTimes.last()) continue;
+        const double step = rates[j] - previous;
+        previous = rates[j];
+        if (rates[j] != 0.0) lastRate = rates[j];
+        if (step == 0.0) continue;
+        problem.changeTimes.append(changeTimes[j]);
+        problem.steps.append(step);
+        problem.levels.append(rates[j]);
+    }
+    if (problem.changeTimes.isEmpty()) {
+        result.message = QStringLiteral("产量历史为空或产量恒为 0");
+        return result;
+    }
+
+    const RateSuperposition history(problem.changeTimes, problem.levels);
+    problem.history = &history;
+
+    // 2. 压力点与所需的响应时间范围
+    const int np = std::min(time.size(), pressure.size());
+    double tauMin = std::numeric_limits<double>::infinity();
+    double tauMax = 0.0;
+    for (int i = 0; i < np; ++i) {
+        if (!std::isfinite(time[i]) || !std::isfinite(pressure[i])) continue;
+        const int count = int(std::lower_bound(problem.changeTimes.constBegin(), problem.changeTimes.constEnd(), time[i])
+                              - problem.changeTimes.constBegin());
+        problem.time.append(time[i]);
+        problem.pressure.append(pressure[i]);
+        problem.source.append(i);
+        problem.changes.append(count);
+        if (count > 0) {
+            tauMin = std::min(tauMin, time[i] - problem.changeTimes[count - 1]);
+            tauMax = std::max(tauMax, time[i] - problem.changeTimes[0]);
+        }
+    }
+    if (!(tauMax > 0.0)) {
+        result.message = QStringLiteral("没有位于第一次产量变化之后的压力点");
+        return result;
+    }
+    tauMin = std::max(tauMin, tauMax * std::pow(10.0, -std::max(1.0, settings.maxDecades)));
+
+    // 3. 节点: 最后一个节点落在 tauMax 上
+    problem.step = std::log(10.0) / std::max(1, settings.nodesPerDecade);
+    problem.nodes = std::max(3, int(std::ceil(std::log(tauMax / tauMin) / problem.step - 1e-9)) + 1);
+    problem.sigma0 = std::log(tauMax) - (problem.nodes - 1) * problem.step;
+    problem.estimateP0 = !std::isfinite(settings.initialPressure);
+    problem.fixedP0 = settings.initialPressure;
+
+    const int nodes = problem.nodes;
+    const int unknowns = problem.unknowns();
+    const int points = problem.time.size();
+
+    // 4. 初始值: z 取常数，使 g(tauMax) 与最大压力变化 / 最大产量相当；初始压力取第一个压力点
+    double p0Guess = problem.estimateP0 ? problem.pressure[0] : problem.fixedP0;
+    for (int i = 0; i < points && problem.estimateP0; ++i) {
+        if (problem.changes[i] == 0) { p0Guess = problem.pressure[i]; break; }
+    }
+    double pressureScale = 0.0;
+    for (int i = 0; i < points; ++i) pressureScale = std::max(pressureScale, std::abs(problem.pressure[i] - p0Guess));
+    double rateScale = 0.0;
+    double cumulative = 0.0;
+    for (double step : problem.steps) {
+        cumulative += step;
+        rateScale = std::max(rateScale, std::abs(cumulative));
+    }
+    if (!(pressureScale > 0.0)) pressureScale = 1.0;
+    if (!(rateScale > 0.0)) rateScale = 1.0;
+
+    Eigen::VectorXd x(unknowns);
+    x.head(nodes).setConstant(std::log(pressureScale / rateScale / nodes / problem.step));
+    if (problem.estimateP0) x[nodes] = p0Guess;
+
+    // 5. 曲率正则: 二阶差分 (稀疏带状)，权重随压力点数与压力变化幅度缩放
+    Eigen::SparseMatrix<double> curvature(nodes - 2, unknowns);
+    {
+        QVector<Eigen::Triplet<double>> entries;
+        for (int k = 0; k + 2 < nodes; ++k) {
+            entries.append(Eigen::Triplet<double>(k, k, 1.0));
+            entries.append(Eigen::Triplet<double>(k, k + 1, -2.0));
+            entries.append(Eigen::Triplet<double>(k, k + 2, 1.0));
+        }
+        curvature.setFromTriplets(entries.begin(), entries.end());
+    }
+    const double lambda = std::max(0.0, settings.regularization) * points * pressureScale * pressureScale;
+    const Eigen::MatrixXd regularNormal = lambda * Eigen::MatrixXd(curvature.transpose() * curvature);
+    auto regularTerm = [&](const Eigen::VectorXd& v) { return lambda * (curvature * v).squaredNorm(); };
+
+    // 6. Levenberg-Marquardt
+    Eigen::MatrixXd normal;
+    Eigen::VectorXd gradient;
+    double cost = assemble(problem, x, &normal, &gradient, nullptr) + regularTerm(x);
+    if (!std::isfinite(cost)) {
+        result.message = QStringLiteral("初始值的目标函数无效");
+        return result;
+    }
+    double damping = 1e-3;
+    int iteration = 0;
+    for (; iteration < settings.maxIterations; ++iteration) {
+        Eigen::MatrixXd H = normal.selfadjointView<Eigen::Lower>();
+        H += regularNormal;
+        const Eigen::VectorXd g = gradient + regularNormal * x;
+
+        bool accepted = false;
+        double decrease = 0.0;
+        while (!accepted && damping < 1e12) {
+            Eigen::MatrixXd A = H;
+            for (int k = 0; k < unknowns; ++k) A(k, k) += damping * std::max(H(k, k), 1e-12);
+            const Eigen::VectorXd delta = A.ldlt().solve(-g);
+            const Eigen::VectorXd trial = x + delta;
+
+            Eigen::MatrixXd trialNormal;
+            Eigen::VectorXd trialGradient;
+            const double trialCost = assemble(problem, trial, &trialNormal, &trialGradient, nullptr) + regularTerm(trial);
+            if (std::isfinite(trialCost) && trialCost < cost) {
+                decrease = (cost - trialCost) / cost;
+                x = trial;
+                cost = trialCost;
+                normal = trialNormal;
+                gradient = trialGradient;
+                damping = std::max(damping * 0.3, 1e-12);
+                accepted = true;
+            } else {
+                damping *= 4.0;
+            }
+        }
+        if (!accepted || decrease < settings.tolerance) {
+            ++iteration;
+            break;
+        }
+    }
+
+    // 7. 输出: 参考产量下的定产压差与导数
+    QVector<double> fitted;
+    const double sse = assemble(problem, x, nullptr, nullptr, &fitted);
+    ResponseTable table(nodes, problem.sigma0, problem.step);
+    table.update(x.data());
+
+    const double referenceRate = (settings.referenceRate != 0.0) ? settings.referenceRate : std::abs(lastRate);
+    result.time.resize(nodes);
+    result.deltaP.resize(nodes);
+    result.derivative.resize(nodes);
+    for (int k = 0; k < nodes; ++k) {
+        result.time[k] = std::exp(problem.sigma0 + k * problem.step);
+        result.deltaP[k] = referenceRate * table.value(k);
+        result.derivative[k] = referenceRate * table.logDerivative(k);
+    }
+    result.fittedPressure = QVector<double>(np, std::numeric_limits<double>::quiet_NaN());
+    for (int i = 0; i < points; ++i) result.fittedPressure[problem.source[i]] = fitted[i];
+    result.initialPressure = problem.initialPressure(x);
+    result.referenceRate = referenceRate;
+    result.rmsMisfit = std::sqrt(sse / std::max(1, points));
+    result.iterations = iteration;
+    result.ok = true;
+    return result;
+}
@@ -0,0 +1,60 @@
+/*
+ * 文件名: deconvolution.h
+ * 文件作用: 压力-产量反褶积头文件
+ * 功能描述:
+ * 1. 由变产量下的实测压力与产量历史反求定产 (单位产量) 压力响应 g(t)，方法参照 von Schroeter / Levitan:
+ *    未知量为 z(sigma) = ln(dg/dln t) (sigma = ln t)，在对数等距节点上分段线性，保证导数为正、g 单调递增。
+ * 2. 目标函数为压力残差平方和加 z 的二阶差分 (曲率) 正则项，初始压力可给定或一同反演；
+ *    非线性最小二乘采用 Levenberg-Marquardt。
+ * 3. Jacobian 不显式存储: 压力点对 z 的偏导只与各产量段所在的节点段及之前各段的累积量有关，按块累加为法方程。
+ *    产量历史按变产量叠加的二叉树 (ratesuperposition.h) 分组，远处的组以 Chebyshev 插值矩代替，
+ *    逐行生成的代价为 O(p log(产量变化次数) + 节点数)，上千次产量变化的长期记录也只需数秒。
+ * 4. 结果为参考产量下的压差与 t*dp/dt，可直接作为拟合界面的观测数据。
+ */
+
+#ifndef DECONVOLUTION_H
+#define DECONVOLUTION_H
+
+#include <QString>
+#include <QVector>
+#include <limits>
+
+class Deconvolution
+{
+public:
+    struct Settings {
+        int nodesPerDecade = 8;         // 每个对数周期的节点数
+        double maxDecades = 6.0;        // 响应时间范围的最大对数周期数 (更早的时间按单位斜率外推)
+        double regularization = 1e-4;   // 曲率正则权重 (相对于压力变化幅度的无量纲值)
+        double initialPressure = std::numeric_limits<double>::quiet_NaN();  // 已知初始压力；NaN 表示一同反演
+        double referenceRate = 0.0;     // 输出压差对应的产量；0 表示取最后一个非零产量的绝对值
+        int maxIterations = 100;
+        double tolerance = 1e-9;        // 目标函数相对下降量的收敛阈值
+    };
+
+    struct Result {
+        bool ok = false;
+        QString message;                // 失败原因
+        QVector<double> time;           // 响应时间 (节点)
+        QVector<double> deltaP;         // 参考产量下的定产压差
+        QVector<double> derivative;     // t*d(deltaP)/dt
+        QVector<double> fittedPressure; // 由反褶积响应重构的压力 (与输入压力点一一对应)
+        double initialPressure = 0.0;
+        double referenceRate = 0.0;
+        double rmsMisfit = 0.0;         // 压力残差的均方根
+        int iterations = 0;
+    };
+
+    // time/pressure 为压力记录；changeTimes 为升序的产量变化时刻，rates[j] 为 [changeTimes[j], changeTimes[j+1]) 内的产量
+    // (产出为正，产出时压力下降)
+    static Result deconvolve(const QVector<double>& time, const QVector<double>& pressure,
+                             const QVector<double>& changeTimes, const QVector<double>& rates,
+                             const Settings& settings);
+    static Result deconvolve(const QVector<double>& time, const QVector<double>& pressure,
+                             const QVector<double>& changeTimes, const QVector<double>& rates);
+
+    // 各段时长 (CurveInfo x2Data 阶梯格式) 转换为产量变化时刻
+    static QVector<double> changeTimesFromDurations(const QVector<double>& durations, double startTime = 0.0);
+};
+
+#endif // DECONVOLUTION_H
@@ -0,0 +1,188 @@
+/*
+ * 文件名: differentialevolution.cpp
+ * 文件作用: 差分进化全局优化器实现文件
+ * 功能描述:
+ * 1. 每个试验个体 (及其廉价变体) 为一个求值任务，一代的全部任务由 QtConcurrent 在独立线程池中并行计算，
+ *    结果按下标写回；选择在全部任务完成后按个体顺序进行。
+ * 2. jDE 自适应: 每个个体以 0.1 的概率重新抽取 F (0.1~1) 与 CR (0~1)，试验个体被选中时保留新值。
+ */
+
+#include "differentialevolution.h"
+#include "multistartfit.h"
+#include "computesupport.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+// 越界分量取父代与边界的中点
+Eigen::VectorXd repair(const Eigen::VectorXd& y, const Eigen::VectorXd& parent,
+                       const Eigen::VectorXd& lower, const Eigen::VectorXd& upper)
+{
+    Eigen::VectorXd z = y;
+    for (Eigen::Index j = 0; j < z.size(); ++j) {
+        if (z[j] < lower[j]) z[j] = 0.5 * (parent[j] + lower[j]);
+        else if (z[j] > upper[j]) z[j] = 0.5 * (parent[j] + upper[j]);
+    }
+    return z;
+}
+
+struct Task {
+    QVector<Eigen::VectorXd> xs;    // 试验个体及其廉价变体 (按顺序求值)
+    QVector<double> costs;
+};
+}
+
+DifferentialEvolution::Result DifferentialEvolution::minimize(const Problem& problem, const QVector<Eigen::VectorXd>& seeds,
+                                                              const Settings& settings, const ProgressCallback& progress,
+                                                              const StopCallback& stopRequested)
+{
+    Result result;
+    const Eigen::Index n = problem.lower.size();
+    if (!problem.cost || n == 0 || problem.upper.size() != n) return result;
+    for (Eigen::Index j = 0; j < n; ++j) {
+        if (!std::isfinite(problem.lower[j]) || !std::isfinite(problem.upper[j]) || problem.upper[j] < problem.lower[j]) return result;
+    }
+
+    const int np = settings.populationSize > 0 ? std::max(4, settings.populationSize)
+                                               : std::min(80, std::max(20, int(10 * n)));
+    std::mt19937 rng(settings.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto randomIndex = [&](int count) { return std::min(count - 1, int(uniform(rng) * count)); };
+
+    // 廉价块
+    QVector<int> cheapBlocks;
+    for (int b : problem.block) {
+        if (b != 0 && !cheapBlocks.contains(b)) cheapBlocks.append(b);
+    }
+    std::sort(cheapBlocks.begin(), cheapBlocks.end());
+    const int variants = cheapBlocks.isEmpty() ? 0 : std::max(0, settings.variantsPerTrial);
+
+    // 1. 初始种群: 调用方的起点 (截断到范围内) 加拉丁超立方样本
+    QVector<Eigen::VectorXd> population;
+    for (const Eigen::VectorXd& s : seeds) {
+        if (population.size() < np && s.size() == n) population.append(s.cwiseMax(problem.lower).cwiseMin(problem.upper));
+    }
+    population << MultiStartFit::latinHypercube(problem.lower, problem.upper, np - population.size(), settings.seed);
+    QVector<double> cost(np, std::numeric_limits<double>::infinity());
+    QVector<double> F(np, 0.5), CR(np, 0.9);
+
+    const int threads = settings.threadCount > 0 ? settings.threadCount : QThread::idealThreadCount();
+    bool stopped = false;
+    auto evaluate = [&](QVector<Task>& tasks) {
+        auto runTask = [&](Task& task) {
+            task.costs = QVector<double>(task.xs.size(), std::numeric_limits<double>::infinity());
+            for (int k = 0; k < task.xs.size(); ++k) {
+                if (stopRequested && stopRequested()) return;
+                const double c = problem.cost(task.xs[k]);
+                if (std::isfinite(c)) task.costs[k] = c;
+            }
+        };
+        if (std::min(threads, int(tasks.size())) <= 1) {
+            for (Task& task : tasks) runTask(task);
+        } else {
+            QtConcurrent::blockingMap(ComputeSupport::pool(ComputeSupport::EvolutionPool, threads), tasks, runTask);
+        }
+        for (const Task& task : tasks) result.evaluations += task.xs.size();
+        if (stopRequested && stopRequested()) stopped = true;
+    };
+
+    {
+        QVector<Task> tasks(np);
+        for (int i = 0; i < np; ++i) tasks[i].xs << population[i];
+        evaluate(tasks);
+        for (int i = 0; i < np; ++i) cost[i] = tasks[i].costs.value(0, std::numeric_limits<double>::infinity());
+    }
+    int best = int(std::min_element(cost.constBegin(), cost.constEnd()) - cost.constBegin());
+    if (!std::isfinite(cost[best])) {
+        result.status = stopped ? Stopped : Failed;
+        return result;
+    }
+
+    result.status = MaxGenerations;
+    int generation = 0;
+    for (; generation < settings.maxGenerations; ++generation) {
+        if (stopped) {
+            result.status = Stopped;
+            break;
+        }
+        const double worst = *std::max_element(cost.constBegin(), cost.constEnd());
+        if (cost[best] < settings.targetCost) {
+            result.status = TargetReached;
+            break;
+        }
+        if (worst - cost[best] <= settings.tolerance * std::max(std::abs(cost[best]), std::numeric_limits<double>::min())) {
+            result.status = Converged;
+            break;
+        }
+
+        // 2. 生成试验个体 (按目标函数排序取 pbest 集合)
+        QVector<int> order(np);
+        for (int i = 0; i < np; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] < cost[b]; });
+        const int top = std::max(2, int(std::lround(settings.pbest * np)));
+
+        QVector<Task> tasks(np);
+        QVector<double> trialF(np), trialCR(np);
+        for (int i = 0; i < np; ++i) {
+            trialF[i] = uniform(rng) < 0.1 ? 0.1 + 0.9 * uniform(rng) : F[i];
+            trialCR[i] = uniform(rng) < 0.1 ? uniform(rng) : CR[i];
+            const double f = trialF[i];
+
+            const int pb = order[randomIndex(top)];
+            int r1, r2;
+            do { r1 = randomIndex(np); } while (r1 == i);
+            do { r2 = randomIndex(np); } while (r2 == i || r2 == r1);
+            const Eigen::VectorXd& x = population[i];
+            const Eigen::VectorXd v = x + f * (population[pb] - x) + f * (population[r1] - population[r2]);
+
+            Eigen::VectorXd u = x;
+            const int jrand = randomIndex(int(n));
+            for (Eigen::Index j = 0; j < n; ++j) {
+                if (j == jrand || uniform(rng) < trialCR[i]) u[j] = v[j];
+            }
+            u = repair(u, x, problem.lower, problem.upper);
+            tasks[i].xs << u;
+
+            // 廉价变体: 只在一个廉价块内再做一次差分扰动，其余分量与试验个体相同
+            for (int k = 0; k < variants; ++k) {
+                const int b = cheapBlocks[k % cheapBlocks.size()];
+                int r3, r4;
+                do { r3 = randomIndex(np); } while (r3 == i);
+                do { r4 = randomIndex(np); } while (r4 == i || r4 == r3);
+                Eigen::VectorXd w = u;
+                for (Eigen::Index j = 0; j < n; ++j) {
+                    if (problem.block.value(int(j), 0) == b) w[j] += f * (population[r3][j] - population[r4][j]);
+                }
+                w = repair(w, u, problem.lower, problem.upper);
+                if (w != u) tasks[i].xs << w;
+            }
+        }
+
+        // 3. 成批求值与选择
+        evaluate(tasks);
+        for (int i = 0; i < np; ++i) {
+            const Task& task = tasks[i];
+            result.variantEvaluations += task.xs.size() - 1;
+            if (task.costs.isEmpty()) continue;
+            const int k = int(std::min_element(task.costs.constBegin(), task.costs.constEnd()) - task.costs.constBegin());
+            if (!(task.costs[k] <= cost[i])) continue;
+            population[i] = task.xs[k];
+            cost[i] = task.costs[k];
+            F[i] = trialF[i];
+            CR[i] = trialCR[i];
+        }
+        best = int(std::min_element(cost.constBegin(), cost.constEnd()) - cost.constBegin());
+        if (progress) progress(generation + 1, population[best], cost[best]);
+    }
+
+    result.x = population[best];
+    result.cost = cost[best];
+    result.generations = generation;
+    return result;
+}
@@ -0,0 +1,70 @@
+/*
+ * 文件名: differentialevolution.h
+ * 文件作用: 差分进化 (Differential Evolution) 全局优化器头文件 (不依赖界面、无需导数)
+ * 功能描述:
+ * 1. 种群在取样范围内按拉丁超立方初始化 (可加入调用方给定的起点)，每代的全部试验个体一次性成批计算，
+ *    分配到独立线程池中并行求值；随机数只在调用线程中生成，结果与线程数无关。
+ * 2. 变异策略为 current-to-pbest/1，二项交叉，个体的 F、CR 按 jDE 方式自适应；越界分量取父代与边界的中点。
+ * 3. 廉价变体: 变量可按计算代价分块 (block 0 为昂贵块，其余为廉价块)，每个试验个体之后在同一任务中
+ *    再求若干只改变某个廉价块的变体，调用方的缓存 (如储层解、无因次主曲线) 在变体之间复用。
+ * 4. 每代结束回调 (进度)，每次求值前检查停止请求。
+ */
+
+#ifndef DIFFERENTIALEVOLUTION_H
+#define DIFFERENTIALEVOLUTION_H
+
+#include <QVector>
+#include <Eigen/Dense>
+#include <functional>
+
+class DifferentialEvolution
+{
+public:
+    struct Settings {
+        int populationSize = 0;         // 0 表示 10 * 变量数 (限制在 20~80)
+        int maxGenerations = 200;
+        int variantsPerTrial = 2;       // 每个试验个体附带的廉价变体数 (没有廉价块时不生成)
+        double pbest = 0.2;             // current-to-pbest 中 pbest 的比例
+        double tolerance = 1e-6;        // 种群目标函数的相对极差低于此值时结束
+        double targetCost = 0.0;        // 最优目标函数低于此值时结束
+        unsigned seed = 1;
+        int threadCount = 0;            // 0 表示 QThread::idealThreadCount()
+    };
+
+    enum Status {
+        Failed = 0,                     // 初始种群中没有可计算的个体
+        Converged,
+        TargetReached,
+        MaxGenerations,
+        Stopped
+    };
+
+    struct Result {
+        Status status = Failed;
+        Eigen::VectorXd x;
+        double cost = 0.0;
+        int generations = 0;
+        int evaluations = 0;
+        int variantEvaluations = 0;     // 其中廉价变体的求值次数
+    };
+
+    // 目标函数: 必须可被多个线程同时调用；非有限值表示该点无法计算
+    using CostFunction = std::function<double(const Eigen::VectorXd& x)>;
+    // 每代结束时调用
+    using ProgressCallback = std::function<void(int generation, const Eigen::VectorXd& best, double bestCost)>;
+    // 返回 true 时停止 (尚未求值的个体不再计算)
+    using StopCallback = std::function<bool()>;
+
+    struct Problem {
+        CostFunction cost;
+        Eigen::VectorXd lower;          // 取样与搜索范围 (必须有限)
+        Eigen::VectorXd upper;
+        QVector<int> block;             // 各变量所属的块 (为空表示全部为昂贵块)
+    };
+
+    static Result minimize(const Problem& problem, const QVector<Eigen::VectorXd>& seeds, const Settings& settings,
+                           const ProgressCallback& progress = ProgressCallback(),
+                           const StopCallback& stopRequested = StopCallback());
+};
+
+#endif // DIFFERENTIALEVOLUTION_H
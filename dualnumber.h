@@ -0,0 +1,124 @@
+/*
+ * 文件名: dualnumber.h
+ * 文件作用: 前向自动微分对偶数类型
+ * 功能描述:
+ * 1. Dual<S> 同时携带函数值 v 与对若干方向 (参数) 的偏导数 d[0..n)，S 为 double 或 std::complex<double>。
+ * 2. 重载四则运算与 sqrt、exp、log、abs、real，使按标量类型模板化的计算代码可直接以对偶数实例化，
+ *    一次计算同时得到函数值和全部偏导数 (无差分步长误差)。
+ * 3. 方向数在运行时确定 (不超过 kMaxDirections)；常数的方向数为 0，参与运算时按偏导为 0 处理。
+ * 4. abs、real 返回函数值的模/实部，仅用于阈值判断与分支选择，不传递导数。
+ */
+
+#ifndef DUALNUMBER_H
+#define DUALNUMBER_H
+
+#include <complex>
+#include <cmath>
+#include <type_traits>
+#include <algorithm>
+
+template<typename S>
+class Dual
+{
+public:
+    static const int kMaxDirections = 10;
+
+    S v;                        // 函数值
+    S d[kMaxDirections];        // 偏导数 (前 n 个有效)
+    int n;                      // 方向数
+
+    Dual() : v(0.0), n(0) {}
+    Dual(const S& value) : v(value), n(0) {}
+    template<typename U, typename = typename std::enable_if<std::is_arithmetic<U>::value && !std::is_same<U, S>::value>::type>
+    Dual(U value) : v(S(value)), n(0) {}
+
+    // 自变量: 值为 value，在第 k 个方向 (共 count 个) 上的偏导为 1
+    static Dual variable(const S& value, int k, int count)
+    {
+        Dual r(value);
+        r.n = count;
+        for (int i = 0; i < count; ++i) r.d[i] = S(0.0);
+        r.d[k] = S(1.0);
+        return r;
+    }
+
+    // 第 i 个方向的偏导 (超出 n 时为 0)
+    S derivative(int i) const { return (i < n) ? d[i] : S(0.0); }
+
+    // r = a*x + b*y 形式的导数组合
+    static Dual combine(const S& value, const S& a, const Dual& x, const S& b, const Dual& y)
+    {
+        Dual r(value);
+        r.n = std::max(x.n, y.n);
+        if (x.n == y.n) {
+            for (int i = 0; i < r.n; ++i) r.d[i] = a * x.d[i] + b * y.d[i];
+        } else {
+            for (int i = 0; i < r.n; ++i) r.d[i] = a * x.derivative(i) + b * y.derivative(i);
+        }
+        return r;
+    }
+
+    // r = a*x 形式的导数 (单变量函数的链式法则)
+    static Dual chain(const S& value, const S& a, const Dual& x)
+    {
+        Dual r(value);
+        r.n = x.n;
+        for (int i = 0; i < r.n; ++i) r.d[i] = a * x.d[i];
+        return r;
+    }
+
+    Dual operator-() const { return chain(-v, S(-1.0), *this); }
+
+    Dual& operator+=(const Dual& o) { return *this = *this + o; }
+    Dual& operator-=(const Dual& o) { return *this = *this - o; }
+    Dual& operator*=(const Dual& o) { return *this = *this * o; }
+    Dual& operator/=(const Dual& o) { return *this = *this / o; }
+
+    friend Dual operator+(const Dual& a, const Dual& b) { return combine(a.v + b.v, S(1.0), a, S(1.0), b); }
+    friend Dual operator-(const Dual& a, const Dual& b) { return combine(a.v - b.v, S(1.0), a, S(-1.0), b); }
+    friend Dual operator*(const Dual& a, const Dual& b) { return combine(a.v * b.v, b.v, a, a.v, b); }
+    friend Dual operator/(const Dual& a, const Dual& b)
+    {
+        S inv = S(1.0) / b.v;
+        S q = a.v * inv;
+        return combine(q, inv, a, -q * inv, b);
+    }
+
+    // 与常数 (S 或实数) 的混合运算
+    template<typename U> using IfScalar = typename std::enable_if<std::is_arithmetic<U>::value || std::is_same<U, S>::value, Dual>::type;
+
+    template<typename U> friend IfScalar<U> operator+(const Dual& a, const U& b) { Dual r = a; r.v += S(b); return r; }
+    template<typename U> friend IfScalar<U> operator+(const U& b, const Dual& a) { Dual r = a; r.v += S(b); return r; }
+    template<typename U> friend IfScalar<U> operator-(const Dual& a, const U& b) { Dual r = a; r.v -= S(b); return r; }
+    template<typename U> friend IfScalar<U> operator-(const U& b, const Dual& a) { return chain(S(b) - a.v, S(-1.0), a); }
+    template<typename U> friend IfScalar<U> operator*(const Dual& a, const U& b) { return chain(a.v * S(b), S(b), a); }
+    template<typename U> friend IfScalar<U> operator*(const U& b, const Dual& a) { return chain(a.v * S(b), S(b), a); }
+    template<typename U> friend IfScalar<U> operator/(const Dual& a, const U& b) { S inv = S(1.0) / S(b); return chain(a.v * inv, inv, a); }
+    template<typename U> friend IfScalar<U> operator/(const U& b, const Dual& a)
+    {
+        S q = S(b) / a.v;
+        return chain(q, -q / a.v, a);
+    }
+
+    // 初等函数 (通过实参相关查找调用，计算代码中需 using std::sqrt 等后不加限定地调用)
+    friend Dual sqrt(const Dual& a) { S r = std::sqrt(a.v); return chain(r, S(0.5) / r, a); }
+    friend Dual exp(const Dual& a) { S e = std::exp(a.v); return chain(e, e, a); }
+    friend Dual log(const Dual& a) { return chain(std::log(a.v), S(1.0) / a.v, a); }
+    friend double abs(const Dual& a) { return std::abs(a.v); }
+    friend double real(const Dual& a) { return std::real(a.v); }
+};
+
+// 标量类型判断与取值 (对 double、std::complex<double> 与 Dual 统一使用)
+template<typename T> struct IsDual : std::false_type {};
+template<typename S> struct IsDual<Dual<S>> : std::true_type {};
+
+// 对偶数的函数值类型 (非对偶数为其自身)
+template<typename T> struct ValueType { using type = T; };
+template<typename S> struct ValueType<Dual<S>> { using type = S; };
+
+// 函数值的实部 (对参数做阈值判断、几何划分时使用)
+inline double valueOf(double x) { return x; }
+inline double valueOf(const std::complex<double>& x) { return x.real(); }
+template<typename S> inline double valueOf(const Dual<S>& x) { return std::real(x.v); }
+
+#endif // DUALNUMBER_H
@@ -0,0 +1,144 @@
+/*
+ * 文件名: laplaceinversion.h
+ * 文件作用: 拉普拉斯数值反演算法头文件
+ * 功能描述:
+ * 1. 提供可切换的反演后端: Stehfest、固定 Talbot、de Hoog、Euler (Abate-Whitt)。
+ * 2. Talbot 与 de Hoog 在同一时间窗口 (默认一个对数周期) 内共用一组复平面取样点，
+ *    大幅减少拉普拉斯空间核函数的调用次数。
+ * 3. 每次反演输出统计信息 (核函数调用次数、估计误差)，便于比较各后端的精度与代价。
+ * 4. 核函数取样与反演求和分离：取样点先全部生成，再按线程数交错分配给线程池并行计算，
+ *    求和顺序固定，因此结果与线程数无关。
+ * 5. 可同时输出对数导数 t*df/dt (由同一组取样得到，不增加核函数调用)。
+ * 6. 多通道反演: 一次取样同时反演多个像函数 (如自动微分得到的参数偏导数)。
+ * 7. Stehfest 误差控制: 设置容差后逐时间点自适应选取阶数 (N 阶的取样点是 N+2 阶的前 N 个，逐轮补取样)，
+ *    各时间点实际阶数与估计误差在 Report 中输出。
+ */
+
+#ifndef LAPLACEINVERSION_H
+#define LAPLACEINVERSION_H
+
+#include <QVector>
+#include <QString>
+#include <complex>
+#include <functional>
+
+class LaplaceInversion
+{
+public:
+    // 反演算法类型
+    enum Method {
+        Stehfest = 0, // Gaver-Stehfest，实轴取样，逐时间点计算
+        Talbot,       // 固定 Talbot 围道，按时间窗口共享取样点
+        DeHoog,       // de Hoog 傅里叶级数 + QD 连分式加速，按时间窗口共享取样点
+        Euler         // Abate-Whitt Euler 求和，逐时间点计算
+    };
+
+    // 拉普拉斯空间函数: 实轴版本用于 Stehfest，复数版本用于其余算法
+    using RealKernel = std::function<double(double)>;
+    using ComplexKernel = std::function<std::complex<double>(const std::complex<double>&)>;
+
+    // 多通道核函数: 在同一取样点输出 channels 个像函数值 (写入 out[0..channels))
+    using RealChannelKernel = std::function<void(double, double*)>;
+    using ComplexChannelKernel = std::function<void(const std::complex<double>&, std::complex<double>*)>;
+    static const int kMaxChannels = 16;
+
+    // 反演统计信息
+    struct Report {
+        Method method = Stehfest;
+        int order = 0;              // 实际使用的阶数
+        int timePoints = 0;         // 参与反演的时间点数
+        int windows = 0;            // 共享取样的时间窗口数 (逐点算法等于时间点数)
+        int kernelCalls = 0;        // 拉普拉斯空间核函数调用次数
+        double maxEstimatedError = 0.0; // 各时间点估计绝对误差的最大值
+        QVector<int> orders;        // 各时间点实际使用的阶数 (与输入时间点一一对应，t <= 0 为 0)
+        QVector<double> errors;     // 各时间点的估计绝对误差
+    };
+
+    explicit LaplaceInversion(Method method = Stehfest, int order = 0);
+
+    void setMethod(Method method);
+    Method method() const { return m_method; }
+
+    // 阶数: Stehfest 为 N (偶数)；Talbot 为围道节点数 M；de Hoog 与 Euler 为 M (取样 2M+1 个)
+    // 传入 0 表示使用该算法的默认阶数
+    void setOrder(int order);
+    int order() const;
+
+    // 共享取样窗口的时间跨度 t_max/t_min (仅 Talbot / de Hoog 使用)；
+    // 窗口边界固定在 ratio 的整数次幂上，取样点只取决于时间点所在的窗口，与同一次反演中的其他时间点无关
+    void setWindowRatio(double ratio);
+    double windowRatio() const { return m_windowRatio; }
+
+    // 并行取样线程数: 0 表示使用 QThread::idealThreadCount()，1 表示在调用线程中串行计算
+    // 核函数必须可以被多个线程同时调用
+    void setThreadCount(int count);
+    int threadCount() const;
+
+    // Stehfest 相对误差容差: > 0 时每个时间点从 order() (不低于 6) 起按 N、N+2、... 增加阶数，直到最近两个相邻阶之差
+    // 都不超过 tol*|f| (或达到 kMaxStehfestOrder、或差值开始增大)；0 表示固定阶数
+    void setTolerance(double tol);
+    double tolerance() const { return m_tolerance; }
+    static const int kMaxStehfestOrder = 18;
+
+    // 原函数初值 f(0+) = lim s*F(s) (s→∞)，用于对数导数；缺省为 0
+    void setInitialValue(double f0);
+    double initialValue() const { return m_initialValue; }
+
+    // 反演入口: 对所有 t > 0 的时间点求 f(t)，t <= 0 的点输出 0
+    // logDerivative 非空时同时输出 t*df/dt (即对 ln t 的导数)
+    QVector<double> invert(const QVector<double>& t, const RealKernel& realF, const ComplexKernel& complexF,
+                           Report* report = nullptr, QVector<double>* logDerivative = nullptr) const;
+
+    // 多通道反演: 返回 values[c][i]；initialValues[c] 为第 c 个通道的 f(0+) (缺省为 0)，
+    // logDerivatives 非空时同时输出各通道的 t*df/dt。channels 超过 kMaxChannels 时不反演，输出全为 0
+    QVector<QVector<double>> invertChannels(const QVector<double>& t, int channels,
+                                            const RealChannelKernel& realF, const ComplexChannelKernel& complexF,
+                                            const QVector<double>& initialValues, Report* report = nullptr,
+                                            QVector<QVector<double>>* logDerivatives = nullptr) const;
+
+    // 各算法的默认阶数
+    static int defaultOrder(Method method);
+    // 获取算法名称
+    static QString getMethodName(Method method);
+    // Stehfest 系数 V_i (N 为偶数)
+    static double stehfestCoefficient(int i, int N);
+
+private:
+    // 逐通道输出 out[c]；deriv 非空时同时输出 t*f'(t)，f0[c] 为各通道初值
+    void invertStehfest(const QVector<double>& t, const RealChannelKernel& F, int channels, const QVector<double>& f0,
+                        QVector<QVector<double>>& out, QVector<QVector<double>>* deriv, Report& rep) const;
+    void invertStehfestAdaptive(const QVector<double>& t, const RealChannelKernel& F, int channels, const QVector<double>& f0,
+                                QVector<QVector<double>>& out, QVector<QVector<double>>* deriv, Report& rep) const;
+    void invertEuler(const QVector<double>& t, const ComplexChannelKernel& F, int channels, const QVector<double>& f0,
+                     QVector<QVector<double>>& out, QVector<QVector<double>>* deriv, Report& rep) const;
+    void invertWindows(const QVector<double>& t, const ComplexChannelKernel& F, int channels, const QVector<double>& f0,
+                       QVector<QVector<double>>& out, QVector<QVector<double>>* deriv, Report& rep) const;
+
+    // 窗口共享算法: 先生成窗口取样点，取样完成后再对窗口内各时间点求和 (Fs 与取样点一一对应)
+    void talbotNodes(double tHi, int M, QVector<std::complex<double>>& s) const;
+    void combineTalbot(const QVector<double>& t, const QVector<int>& idx, double tHi, int M, const std::complex<double>* Fs,
+                       QVector<double>& out, Report& rep) const;
+    void deHoogNodes(double tHi, int M, QVector<std::complex<double>>& s) const;
+    void combineDeHoog(const QVector<double>& t, const QVector<int>& idx, double tHi, int M, const std::complex<double>* Fs,
+                       QVector<double>& out, Report& rep) const;
+
+    // 并行计算核函数取样值 (NaN/Inf 置 0)，按通道返回 Fs[c][i]
+    QVector<QVector<double>> sample(const QVector<double>& s, const RealChannelKernel& F, int channels) const;
+    QVector<QVector<std::complex<double>>> sample(const QVector<std::complex<double>>& s,
+                                                  const ComplexChannelKernel& F, int channels) const;
+
+    // 按 m_windowRatio 将时间点划分为若干窗口 (返回各窗口内的下标，upper 为各窗口的上限时间)
+    QVector<QVector<int>> buildWindows(const QVector<double>& t, QVector<double>& upper) const;
+
+    static double factorial(int n);
+
+private:
+    Method m_method;
+    int m_order;
+    double m_windowRatio;
+    int m_threadCount;
+    double m_initialValue;
+    double m_tolerance;
+};
+
+#endif // LAPLACEINVERSION_H
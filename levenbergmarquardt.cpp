@@ -0,0 +1,200 @@
+/*
+ * 文件名: levenbergmarquardt.cpp
+ * 文件作用: Levenberg-Marquardt 非线性最小二乘求解器实现文件
+ * 功能描述:
+ * 1. 阻尼项 D = sqrt(lambda * (1 + |J_i|^2)) (与列范数成比例的 Marquardt 缩放)，
+ *    阻尼子问题用 [R; D] 的 QR 分解求解，试探步不再重复组装或复制大矩阵。
+ * 2. 线性模型的预测下降量 |Q^T r|^2 - |Q^T r + R delta|^2 用于调整信赖域半径。
+ * 3. Broyden 秩一更新 J += (dr - J s) s^T / (s^T s) 直接作用于列存储的 J，s 为截断到边界后实际的步长；
+ *    只用于调用方标明为差分近似的 J。
+ */
+
+#include "levenbergmarquardt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// J 的 QR 分解: J = Q [R; 0]，R 为 min(m, n) x n 的上三角阵
+struct Factorization {
+    Eigen::MatrixXd R;
+    Eigen::VectorXd columnNorms2;   // J 各列范数平方 (= R 各列范数平方)
+    Eigen::VectorXd qtr;            // Q^T r 的前 min(m, n) 个分量
+};
+
+Factorization factorize(const Eigen::MatrixXd& J, const Eigen::VectorXd* r)
+{
+    Factorization f;
+    const Eigen::Index k = std::min(J.rows(), J.cols());
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(J);
+    f.R = qr.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+    f.columnNorms2 = f.R.colwise().squaredNorm().transpose();
+    if (r) {
+        Eigen::VectorXd qtr = *r;
+        qtr.applyOnTheLeft(qr.householderQ().adjoint());
+        f.qtr = qtr.head(k);
+    }
+    return f;
+}
+
+double conditionOfR(const Eigen::MatrixXd& R)
+{
+    if (R.cols() == 0) return 0.0;
+    if (R.rows() < R.cols()) return std::numeric_limits<double>::infinity();
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(R);
+    const Eigen::VectorXd& s = svd.singularValues();
+    const double smin = s[s.size() - 1];
+    return smin > 0.0 ? s[0] / smin : std::numeric_limits<double>::infinity();
+}
+
+Eigen::VectorXd clampToBounds(const Eigen::VectorXd& x, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper)
+{
+    Eigen::VectorXd y = x;
+    if (lower.size() == x.size()) y = y.cwiseMax(lower);
+    if (upper.size() == x.size()) y = y.cwiseMin(upper);
+    return y;
+}
+}
+
+double LevenbergMarquardt::conditionNumber(const Eigen::MatrixXd& J)
+{
+    return conditionOfR(factorize(J, nullptr).R);
+}
+
+LevenbergMarquardt::Result LevenbergMarquardt::minimize(const Problem& problem, const Eigen::VectorXd& x0)
+{
+    return minimize(problem, x0, Settings());
+}
+
+LevenbergMarquardt::Result LevenbergMarquardt::minimize(const Problem& problem, const Eigen::VectorXd& x0, const Settings& settings)
+{
+    Result result;
+    const Eigen::Index n = x0.size();
+    Eigen::VectorXd x = clampToBounds(x0, problem.lower, problem.upper);
+    result.x = x;
+
+    Eigen::VectorXd r;
+    ++result.residualEvaluations;
+    if (!problem.residuals || !problem.jacobian || !problem.residuals(x, r) || r.size() == 0) return result;
+    const Eigen::Index m = r.size();
+    double sse = r.squaredNorm();
+    result.residualCount = int(m);
+    result.sse = sse;
+    if (!std::isfinite(sse)) return result;
+    result.status = MaxIterations;
+
+    double lambda = settings.initialDamping;
+    Eigen::MatrixXd J;
+    bool jacobianFresh = false;
+    bool jacobianApproximate = true;
+    bool needRefresh = true;
+    int broydenUpdates = 0;
+    double trustRadius = settings.trustRadiusInitial;
+
+    int iter = 0;
+    for (; iter < settings.maxIterations; ++iter) {
+        if (problem.iterationStarted && !problem.iterationStarted(iter)) {
+            result.status = Stopped;
+            break;
+        }
+        if (sse / m < settings.targetMeanSquare) {
+            result.status = TargetReached;
+            break;
+        }
+
+        if (needRefresh) {
+            ++result.jacobianEvaluations;
+            jacobianApproximate = true;
+            if (!problem.jacobian(x, r, J, jacobianApproximate) || J.rows() != m || J.cols() != n) {
+                result.status = Failed;
+                break;
+            }
+            jacobianFresh = true;
+            needRefresh = false;
+            broydenUpdates = 0;
+        }
+
+        const Factorization f = factorize(J, &r);
+        const Eigen::Index k = f.R.rows();
+        result.conditionNumber = conditionOfR(f.R);
+
+        // 阻尼子问题 min |R delta + Q^T r|^2 + |D delta|^2 的系数阵，每次试探只改写下方的对角块
+        Eigen::MatrixXd A = Eigen::MatrixXd::Zero(k + n, n);
+        A.topRows(k) = f.R;
+        Eigen::VectorXd b = Eigen::VectorXd::Zero(k + n);
+        b.head(k) = -f.qtr;
+
+        bool stepAccepted = false;
+        for (int trial = 0; trial < settings.maxTrials; ++trial) {
+            A.bottomRows(n) = (lambda * (Eigen::VectorXd::Ones(n) + f.columnNorms2)).cwiseSqrt().asDiagonal();
+            Eigen::VectorXd delta = A.householderQr().solve(b);
+
+            // 信赖域: 秩一更新后的 J 求得的步长超过半径时按比例缩短
+            double stepNorm = delta.norm();
+            if (!jacobianFresh && stepNorm > trustRadius) {
+                delta *= trustRadius / stepNorm;
+                stepNorm = trustRadius;
+            }
+            const double predicted = f.qtr.squaredNorm() - (f.qtr + f.R * delta).squaredNorm();
+
+            const Eigen::VectorXd trialX = clampToBounds(x + delta, problem.lower, problem.upper);
+            Eigen::VectorXd trialR;
+            ++result.residualEvaluations;
+            const bool valid = problem.residuals(trialX, trialR) && trialR.size() == m;
+            const double trialSSE = valid ? trialR.squaredNorm() : std::numeric_limits<double>::quiet_NaN();
+
+            if (trialSSE < sse) {
+                const double rho = predicted > 0.0 ? (sse - trialSSE) / predicted : 0.0;
+                if (rho > 0.75) trustRadius = std::min(settings.trustRadiusMax, std::max(trustRadius, 2.0 * stepNorm));
+                else if (rho < 0.25) trustRadius = std::max(settings.trustRadiusMin, 0.5 * stepNorm);
+
+                if (jacobianApproximate && settings.broydenRefreshInterval > 0) {
+                    const Eigen::VectorXd s = trialX - x;
+                    const double ss = s.squaredNorm();
+                    if (ss > 0.0) {
+                        const Eigen::VectorXd u = ((trialR - r) - J * s) / ss;
+                        J.noalias() += u * s.transpose();
+                    }
+                    ++broydenUpdates;
+                    jacobianFresh = false;
+                    needRefresh = (broydenUpdates >= settings.broydenRefreshInterval)
+                                  || ((sse - trialSSE) / sse < settings.broydenStallDecrease);
+                } else {
+                    needRefresh = true;
+                }
+
+                x = trialX;
+                r = trialR;
+                sse = trialSSE;
+                lambda /= 10.0;
+                stepAccepted = true;
+                if (problem.stepAccepted) problem.stepAccepted(x, sse / m);
+                break;
+            }
+
+            // 秩一更新后的 J 可能已失准: 缩小信赖域并完整重算后再试，不加大阻尼
+            if (!jacobianFresh) {
+                trustRadius = std::max(settings.trustRadiusMin, 0.5 * stepNorm);
+                needRefresh = true;
+                break;
+            }
+            lambda *= 10.0;
+        }
+        // 只为重算 J 而结束的迭代不计数 (重算后 J 为最新，不会连续发生)
+        if (!stepAccepted && needRefresh) {
+            --iter;
+            continue;
+        }
+        if (!stepAccepted && lambda > settings.maxDamping) {
+            result.status = Stalled;
+            ++iter;
+            break;
+        }
+    }
+
+    result.x = x;
+    result.sse = sse;
+    result.iterations = iter;
+    return result;
+}
@@ -0,0 +1,84 @@
+/*
+ * 文件名: levenbergmarquardt.h
+ * 文件作用: Levenberg-Marquardt 非线性最小二乘求解器头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 残差与 Jacobian 由调用方以函数对象提供，优化变量为 Eigen 向量 (调用方负责对数/线性参数化)，
+ *    变量超出上下限时截断到边界。
+ * 2. Jacobian 按列存储在连续的 Eigen::MatrixXd 中；每次迭代对 J 做一次 Householder QR，
+ *    各阻尼试探只需求解 2n x n 的小规模最小二乘 [R; D] delta = [-Q^T r; 0]，不构造法方程 J^T J。
+ * 3. 条件数由 R 的奇异值 (SVD) 给出，随结果输出。
+ * 4. 差分近似的 Jacobian (代价为 n 次以上残差计算) 在接受步长后用 Broyden 秩一公式更新，
+ *    每 broydenRefreshInterval 次、下降停滞或试探失败时才完整重算；由更新后的 J 求得的步长受信赖域半径限制。
+ *    试探失败后只为重算 J 而结束的迭代不计入 maxIterations。精确 (解析、自动微分) 的 Jacobian 每次迭代重算。
+ * 5. 每次迭代开始与接受步长时回调调用方 (进度显示、中途停止)。
+ */
+
+#ifndef LEVENBERGMARQUARDT_H
+#define LEVENBERGMARQUARDT_H
+
+#include <Eigen/Dense>
+#include <functional>
+
+class LevenbergMarquardt
+{
+public:
+    struct Settings {
+        int maxIterations = 50;
+        int maxTrials = 5;                  // 每次迭代的阻尼试探次数
+        double initialDamping = 0.01;
+        double maxDamping = 1e10;           // 阻尼超过此值且无法下降时结束
+        double targetMeanSquare = 0.0;      // 残差均方低于此值时结束
+        int broydenRefreshInterval = 4;     // 连续秩一更新的最大次数 (0 表示每次迭代都完整重算)
+        double broydenStallDecrease = 1e-2; // 接受步长的相对下降量低于此值时下次完整重算
+        double trustRadiusInitial = 1.0;    // 信赖域半径 (优化变量空间的欧氏范数)
+        double trustRadiusMin = 1e-4;
+        double trustRadiusMax = 4.0;
+    };
+
+    enum Status {
+        Failed = 0,         // 初始残差或 Jacobian 无法计算
+        TargetReached,      // 残差均方低于 targetMeanSquare
+        Stalled,            // 阻尼已达上限仍无法下降
+        MaxIterations,
+        Stopped             // 回调要求停止
+    };
+
+    struct Result {
+        Status status = Failed;
+        Eigen::VectorXd x;
+        double sse = 0.0;                   // 残差平方和
+        int residualCount = 0;
+        int iterations = 0;
+        int jacobianEvaluations = 0;        // 完整计算 Jacobian 的次数
+        int residualEvaluations = 0;
+        double conditionNumber = 0.0;       // 最后一次使用的 Jacobian 的条件数 (秩亏时为 inf)
+    };
+
+    // 返回 false 表示该点无法计算 (试探步视为失败)
+    using ResidualFunction = std::function<bool(const Eigen::VectorXd& x, Eigen::VectorXd& r)>;
+    // r 为 x 处的残差；J 输出为 r.size() x x.size()；approximate 输出 J 是否为差分近似 (调用前为 true)，
+    // 只有差分近似的 J 才用 Broyden 秩一更新代替重算
+    using JacobianFunction = std::function<bool(const Eigen::VectorXd& x, const Eigen::VectorXd& r, Eigen::MatrixXd& J,
+                                                bool& approximate)>;
+    // 每次迭代开始时调用，返回 false 停止
+    using IterationCallback = std::function<bool(int iteration)>;
+    // 接受步长后调用 (meanSquare 为残差均方)
+    using StepCallback = std::function<void(const Eigen::VectorXd& x, double meanSquare)>;
+
+    struct Problem {
+        ResidualFunction residuals;
+        JacobianFunction jacobian;
+        Eigen::VectorXd lower;              // 为空表示无下限
+        Eigen::VectorXd upper;              // 为空表示无上限
+        IterationCallback iterationStarted;
+        StepCallback stepAccepted;
+    };
+
+    static Result minimize(const Problem& problem, const Eigen::VectorXd& x0, const Settings& settings);
+    static Result minimize(const Problem& problem, const Eigen::VectorXd& x0);
+
+    // J 的条件数 sigma_max / sigma_min (列数为 0 时返回 0)
+    static double conditionNumber(const Eigen::MatrixXd& J);
+};
+
+#endif // LEVENBERGMARQUARDT_H
@@ -7,17 +7,73 @@
  * 3. 应用全局样式表 (StyleSheet) 以美化界面控件（包含新增的复选框样式）
  * 4. 设置全局调色板以适配不同系统主题的文本颜色
  * 5. 启动主窗口
+ * 6. 命令行参数 --build-type-curves [文件路径] 时不启动界面，离线生成类型曲线库后退出；
+ *    生成前先按 Boost 校验贝塞尔函数的向量化与标量路径，误差超限时不生成并返回非零值
  */
 
 #include "mainwindow.h"
+#include "modelmanager.h"
+#include "typecurvelibrary.h"
+#include "besselfunctions.h"
 #include <QApplication>
 #include <QStyleFactory>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QIcon>
 
+// 贝塞尔函数精度校验: 向量化 (处理器支持时) 与标量两条路径分别与 Boost 对比
+static bool verifyBesselFunctions()
+{
+    bool ok = true;
+    for (bool simd : {true, false}) {
+        BesselFunctions::setSimdEnabled(simd);
+        const BesselFunctions::AccuracyReport rep = BesselFunctions::verifyAgainstBoost();
+        qInfo().noquote() << QString("贝塞尔函数校验 (%1): K0 %2, K1 %3, I0e %4, I1e %5")
+                                 .arg(rep.simdUsed ? QString("AVX2") : QString("标量"))
+                                 .arg(rep.maxRelErrorK0, 0, 'e', 2).arg(rep.maxRelErrorK1, 0, 'e', 2)
+                                 .arg(rep.maxRelErrorI0e, 0, 'e', 2).arg(rep.maxRelErrorI1e, 0, 'e', 2);
+        if (!(rep.maxRelError() <= BesselFunctions::kAccuracyTolerance)) {
+            qCritical().noquote() << QString("贝塞尔函数相对误差 %1 超过上限 %2")
+                                         .arg(rep.maxRelError(), 0, 'e', 2)
+                                         .arg(BesselFunctions::kAccuracyTolerance, 0, 'e', 0);
+            ok = false;
+        }
+    }
+    BesselFunctions::setSimdEnabled(true);
+    return ok;
+}
+
+// 离线生成类型曲线库 (默认网格)，路径缺省为程序目录下的 typecurves.wtl
+static int buildTypeCurveLibrary(int argc, char *argv[], int optionIndex)
+{
+    QCoreApplication app(argc, argv);
+    if (!verifyBesselFunctions()) return 1;
+    const QString path = optionIndex + 1 < argc ? QString::fromLocal8Bit(argv[optionIndex + 1])
+                                                : ModelManager::defaultTypeCurveLibraryPath();
+    int lastPercent = -1;
+    QString error;
+    const bool ok = TypeCurveLibrary::generate(path, TypeCurveLibrary::GenerationSpec::defaultSpec(), &error,
+                                               [&lastPercent](int done, int total) {
+        const int percent = total > 0 ? done * 100 / total : 100;
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            qInfo().noquote() << QString("生成类型曲线库: %1%").arg(percent);
+        }
+    });
+    if (!ok) {
+        qCritical().noquote() << error;
+        return 1;
+    }
+    qInfo().noquote() << "类型曲线库已写入" << path;
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--build-type-curves") == 0) return buildTypeCurveLibrary(argc, argv, i);
+    }
+
 // 解决 HighDpiScaling 在 Qt6 中已废弃的警告
 // 只有在 Qt 6.0 之前的版本才需要手动启用，Qt 6 默认启用
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
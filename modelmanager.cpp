@@ -5,6 +5,11 @@
  * 1. 实例化并管理 6 个 WT_ModelWidget (用于界面显示)。
  * 2. 实例化并管理 6 个 ModelSolver01_06 (用于后台计算)。
  * 3. 处理模型选择逻辑，分发计算任务。
+ * 4. 模型清单与特征 (边界、井储) 来自求解器的模型注册表，本类只做按类型的转发。
+ * 5. 初始化时尝试加载程序目录下的类型曲线库，加载成功后界面的敏感性曲线、拟合页的滚轮预览与自动初值的参考曲线使用库插值。
+ * 6. calculateTheoreticalCurve 先查结果缓存，未命中时计算并写入；析构时输出缓存命中统计。
+ * 7. 精度与反演设置只修改全局默认选项 (加锁)，计算时取一份副本传给只读的求解器。
+ * 8. 变产量曲线直接转发给求解器 (单位响应网格随产量历史变化，不进入结果缓存)。
  */
 
 #include "modelmanager.h"
@@ -18,6 +23,8 @@
 #include <QLabel>
 #include <QGroupBox>
 #include <QDebug>
+#include <QCoreApplication>
+#include <QFileInfo>
 #include <cmath>
 
 ModelManager::ModelManager(QWidget* parent)
@@ -43,10 +50,9 @@ void ModelManager::initializeModels(QWidget* parentWidget)
     m_modelWidgets.clear();
     m_solvers.clear();
 
-    // 循环创建 6 组界面和求解器
-    // 使用 ModelSolver01_06::Model_x 枚举
+    // 按模型注册表顺序创建界面和求解器 (下标与 ModelType 一致)
     using MT = ModelSolver01_06::ModelType;
-    QList<MT> types = { MT::Model_1, MT::Model_2, MT::Model_3, MT::Model_4, MT::Model_5, MT::Model_6 };
+    const QVector<MT> types = ModelSolver01_06::registeredModels();
 
     for(MT type : types) {
         // 1. 创建界面对象，用于显示和交互
@@ -57,14 +63,20 @@ void ModelManager::initializeModels(QWidget* parentWidget)
         // 连接子界面的模型选择请求信号
         connect(widget, &WT_ModelWidget::requestModelSelection, this, &ModelManager::onSelectModelClicked);
 
-        // 2. 创建独立的求解器对象，用于后台/拟合计算
-        ModelSolver01_06* solver = new ModelSolver01_06(type);
-        m_solvers.append(solver);
+        // 2. 创建独立的求解器对象，用于后台/拟合计算 (设置随每次调用传入，求解器本身不再修改)
+        m_solvers.append(new ModelSolver01_06(type));
     }
 
     m_mainWidget->layout()->addWidget(m_modelStack);
     connectModelSignals();
 
+    // 类型曲线库为可选文件 (由 --build-type-curves 离线生成)，不存在时预览退化为精确计算
+    const QString libraryPath = defaultTypeCurveLibraryPath();
+    if (QFileInfo::exists(libraryPath)) {
+        QString error;
+        if (!loadTypeCurveLibrary(libraryPath, &error)) qWarning() << error;
+    }
+
     switchToModel(Model_1);
 
     if (parentWidget->layout()) parentWidget->layout()->addWidget(m_mainWidget);
@@ -137,10 +149,42 @@ void ModelManager::setHighPrecision(bool high) {
     for(WT_ModelWidget* w : m_modelWidgets) {
         w->setHighPrecision(high);
     }
-    // 2. 设置后台求解器精度 (关键：拟合时使用的是这里的求解器)
-    for(ModelSolver01_06* s : m_solvers) {
-        s->setHighPrecision(high);
+    // 2. 设置后台计算的默认精度 (拟合线程可另带选项)
+    QMutexLocker locker(&m_optionsMutex);
+    m_options.highPrecision = high;
+}
+
+void ModelManager::setInversionMethod(LaplaceInversion::Method method, int order) {
+    for(WT_ModelWidget* w : m_modelWidgets) {
+        w->setInversionMethod(method, order);
+    }
+    QMutexLocker locker(&m_optionsMutex);
+    m_options.inversionMethod = method;
+    m_options.inversionOrder = order;
+}
+
+void ModelManager::setThreadCount(int count) {
+    for(WT_ModelWidget* w : m_modelWidgets) {
+        w->setThreadCount(count);
+    }
+    QMutexLocker locker(&m_optionsMutex);
+    m_options.threadCount = count;
+}
+
+void ModelManager::setAsymptoticTolerance(double tol) {
+    for(WT_ModelWidget* w : m_modelWidgets) {
+        w->setAsymptoticTolerance(tol);
     }
+    QMutexLocker locker(&m_optionsMutex);
+    m_options.asymptoticTolerance = std::max(0.0, tol);
+}
+
+void ModelManager::setInversionTolerance(double tol) {
+    for(WT_ModelWidget* w : m_modelWidgets) {
+        w->setInversionTolerance(tol);
+    }
+    QMutexLocker locker(&m_optionsMutex);
+    m_options.inversionTolerance = std::max(0.0, tol);
 }
 
 void ModelManager::updateAllModelsBasicParameters()
@@ -175,7 +219,8 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
     p.insert("lambda1", 1e-3);
     p.insert("gamaD", 0.02);
 
-    if (type == Model_1 || type == Model_3 || type == Model_5) {
+    const ModelSolver01_06::ModelKernel& kernel = ModelSolver01_06::modelKernel(type);
+    if (kernel.hasStorage) {
         p.insert("cD", 0.01);
         p.insert("S", 1.0);
     } else {
@@ -183,7 +228,7 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
         p.insert("S", 0.0);
     }
 
-    if (type == Model_3 || type == Model_4 || type == Model_5 || type == Model_6) {
+    if (kernel.bounded) {
         p.insert("reD", 10.0);
     }
 
@@ -192,11 +237,110 @@ QMap<QString, double> ModelManager::getDefaultParameters(ModelType type)
 
 // [核心修改] 使用独立的 Solver 进行计算，不再调用 Widget 方法
 ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    return calculateTheoreticalCurve(type, params, providedTime, solverOptions());
+}
+
+ModelCurveData ModelManager::calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                       const SolverOptions& options)
 {
     int index = (int)type;
     // 使用 m_solvers 而不是 m_modelWidgets
     if (index >= 0 && index < m_solvers.size()) {
-        return m_solvers[index]->calculateTheoreticalCurve(params, providedTime);
+        const QVector<double> settings = options.key();
+        ModelCurveData curve;
+        if (m_curveCache.lookup(index, params, providedTime, settings, &curve)) return curve;
+
+        curve = m_solvers[index]->calculateTheoreticalCurve(params, providedTime, options);
+        m_curveCache.insert(index, params, providedTime, settings, curve);
+        return curve;
+    }
+    return ModelCurveData();
+}
+
+SolverOptions ModelManager::solverOptions() const
+{
+    QMutexLocker locker(&m_optionsMutex);
+    return m_options;
+}
+
+CurveCache::Stats ModelManager::curveCacheStats() const
+{
+    return m_curveCache.stats();
+}
+
+void ModelManager::setCurveCacheLimit(qint64 bytes)
+{
+    m_curveCache.setMaxBytes(bytes);
+}
+
+void ModelManager::clearCurveCache()
+{
+    m_curveCache.clear();
+}
+
+ModelCurveData ModelManager::calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    return calculatePreviewCurve(type, params, providedTime, solverOptions());
+}
+
+ModelCurveData ModelManager::calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                   const SolverOptions& options)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_solvers.size()) {
+        return m_solvers[index]->calculatePreviewCurve(params, providedTime, options);
+    }
+    return ModelCurveData();
+}
+
+bool ModelManager::loadTypeCurveLibrary(const QString& path, QString* error)
+{
+    const bool ok = m_typeCurveLibrary.open(path, error);
+    const TypeCurveLibrary* library = ok ? &m_typeCurveLibrary : nullptr;
+    for(WT_ModelWidget* w : m_modelWidgets) {
+        w->setTypeCurveLibrary(library);
+    }
+    {
+        QMutexLocker locker(&m_optionsMutex);
+        m_options.typeCurveLibrary = library;
+    }
+    if (ok) qDebug() << "已加载类型曲线库:" << path;
+    return ok;
+}
+
+QString ModelManager::defaultTypeCurveLibraryPath()
+{
+    return QCoreApplication::applicationDirPath() + "/typecurves.wtl";
+}
+
+CurveSensitivity ModelManager::calculateSensitivities(ModelType type, const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names)
+{
+    return calculateSensitivities(type, params, t, names, solverOptions());
+}
+
+CurveSensitivity ModelManager::calculateSensitivities(ModelType type, const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names,
+                                                      const SolverOptions& options)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_solvers.size()) {
+        return m_solvers[index]->calculateSensitivities(params, t, names, options);
+    }
+    return CurveSensitivity();
+}
+
+ModelCurveData ModelManager::calculateVariableRateCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                                                        const RateSuperposition& history)
+{
+    return calculateVariableRateCurve(type, params, t, history, solverOptions());
+}
+
+ModelCurveData ModelManager::calculateVariableRateCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                                                        const RateSuperposition& history, const SolverOptions& options)
+{
+    int index = (int)type;
+    if (index >= 0 && index < m_solvers.size()) {
+        return m_solvers[index]->calculateVariableRateCurve(params, t, history, options);
     }
     return ModelCurveData();
 }
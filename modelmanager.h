@@ -5,6 +5,11 @@
  * 1. 管理所有试井模型界面 (WT_ModelWidget) 的显示与切换。
  * 2. 管理所有数学模型求解器 (ModelSolver01_06) 的实例与计算。
  * 3. 协调模型计算请求，实现界面与算法的解耦。
+ * 4. 持有类型曲线库 (预计算的无因次储层解)，供各求解器的预览曲线使用。
+ * 5. 理论曲线结果缓存 (LRU，线程安全)：相同模型、参数、时间序列与求解器设置的重复请求直接返回缓存结果。
+ * 6. 求解器构造后只读，精度与反演设置保存为全局默认选项 (SolverOptions)，每次计算按值传给求解器；
+ *    拟合线程可带自己的选项调用，不修改全局设置，多个拟合页可与界面刷新同时计算。
+ * 7. 变产量曲线：按产量历史 (RateSuperposition) 叠加单位产量响应。
  */
 
 #ifndef MODELMANAGER_H
@@ -15,10 +20,14 @@
 #include <QVector>
 #include <QStackedWidget>
 #include <QPushButton>
+#include <QMutex>
 
 // 引入新的界面类和求解器类头文件
 #include "wt_modelwidget.h"
 #include "modelsolver01-06.h"
+#include "typecurvelibrary.h"
+#include "curvecache.h"
+#include "ratesuperposition.h"
 
 class ModelManager : public QObject
 {
@@ -46,8 +55,40 @@ public:
     // 获取模型名称描述
     static QString getModelTypeName(ModelType type);
 
-    // 核心计算接口：代理给对应的 Solver 进行计算 (线程安全，可在拟合线程调用)
+    // 核心计算接口：代理给对应的 Solver 进行计算 (线程安全，可在拟合线程调用)；先查结果缓存
+    // 不带 options 时使用全局默认选项
     ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculateTheoreticalCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                             const SolverOptions& options);
+
+    // 预览曲线：类型曲线库插值的快速近似 (库未加载或参数超出库的范围时等同 calculateTheoreticalCurve)
+    // 不带 options 时使用全局默认选项；带 options 的版本可在拟合线程调用 (options 中的类型曲线库决定是否插值)
+    ModelCurveData calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculatePreviewCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                         const SolverOptions& options);
+
+    // 加载类型曲线库并设置给所有界面与求解器 (失败时不使用库)；默认位置为程序目录下的 typecurves.wtl
+    bool loadTypeCurveLibrary(const QString& path, QString* error = nullptr);
+    static QString defaultTypeCurveLibraryPath();
+
+    // 理论曲线结果缓存: 统计信息、内存上限 (字节，0 为关闭缓存)、清空
+    CurveCache::Stats curveCacheStats() const;
+    void setCurveCacheLimit(qint64 bytes);
+    void clearCurveCache();
+
+    // 参数灵敏度：曲线及其对 names 中各参数的偏导数 (自动微分，一次计算)
+    CurveSensitivity calculateSensitivities(ModelType type, const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names);
+    CurveSensitivity calculateSensitivities(ModelType type, const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names,
+                                            const SolverOptions& options);
+
+    // 变产量曲线：<t, 压差, t*d(压差)/dt>，产量取自 history (不使用参数 q)
+    ModelCurveData calculateVariableRateCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                                              const RateSuperposition& history);
+    ModelCurveData calculateVariableRateCurve(ModelType type, const QMap<QString, double>& params, const QVector<double>& t,
+                                              const RateSuperposition& history, const SolverOptions& options);
+
+    // 全局默认选项的副本 (拟合线程可在此基础上修改后传入上面的接口)
+    SolverOptions solverOptions() const;
 
     // 获取默认参数
     QMap<QString, double> getDefaultParameters(ModelType type);
@@ -55,6 +96,15 @@ public:
     // 设置全局计算精度
     void setHighPrecision(bool high);
 
+    // 设置全局拉普拉斯反演算法 (order 为 0 时按精度模式选取默认阶数)
+    void setInversionMethod(LaplaceInversion::Method method, int order = 0);
+    // 设置反演取样线程数 (0 为自动)
+    void setThreadCount(int count);
+    // 设置早期/晚期渐近段捷径的容差 (0 为关闭)
+    void setAsymptoticTolerance(double tol);
+    // 设置 Stehfest 自适应选阶的相对误差容差 (0 为固定阶数)
+    void setInversionTolerance(double tol);
+
     // 刷新所有界面模型的参数显示
     void updateAllModelsBasicParameters();
 
@@ -87,8 +137,18 @@ private:
     // [修改] 界面列表使用 WT_ModelWidget
     QVector<WT_ModelWidget*> m_modelWidgets;
 
-    // [新增] 求解器列表，用于纯数学计算 (与界面分离)
-    QVector<ModelSolver01_06*> m_solvers;
+    // [新增] 求解器列表，用于纯数学计算 (与界面分离)；构造后只读，可被多个线程同时调用
+    QVector<const ModelSolver01_06*> m_solvers;
+
+    // 全局默认选项 (设置函数与计算线程共用，读写加锁)
+    SolverOptions m_options;
+    mutable QMutex m_optionsMutex;
+
+    // 类型曲线库 (内存映射，界面与求解器只持有指针)
+    TypeCurveLibrary m_typeCurveLibrary;
+
+    // 理论曲线结果缓存 (键含求解器设置，切换精度或反演算法后旧结果不会被误用)
+    CurveCache m_curveCache;
 
     ModelType m_currentModelType;
 
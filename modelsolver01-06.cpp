@@ -2,28 +2,518 @@
  * modelsolver01-06.cpp
  * 文件作用: 压裂水平井复合页岩油模型核心计算类实现
  * 功能描述:
- * 1. 实现6种不同边界和井储条件组合的页岩油数学模型解。
- * 2. 包含 Stehfest 数值反演算法、自适应高斯积分、Bessel 函数调用等核心算法。
+ * 1. 实现6种不同边界和井储条件组合的页岩油数学模型解：边界策略 (无限大/封闭/定压) 与井储策略 (变井储/恒定井储)
+ *    为编译期类型，组合后各自实例化一份无分支的拉普拉斯空间核函数，由模型注册表统一分派。
+ * 2. 包含数值反演调度 (Stehfest/Talbot/de Hoog/Euler)、定节点 Gauss-Legendre 积分 (解析扣除 K0 对数奇异项)、Bessel 函数调用等核心算法。
  * 3. 实现了数据处理和物理量到无因次量的转换逻辑。
+ * 4. 带井储模型反演时按储层参数记忆 pf(z)，cD、S 变化只重算井储表皮修正。
+ * 5. 早期/晚期渐近段识别: 由拉普拉斯空间实轴取样拟合幂律、对数与拟稳态形式，满足容差的时间点解析计算。
+ * 6. 预览曲线: pf(z) 由类型曲线库插值，井储表皮与压敏修正照常计算，库未覆盖时回退到精确解。
+ * 7. 储层解记忆表与主曲线缓存的条数随线程数增加，多线程并发计算不同参数组时各自的条目不会相互挤出。
  */
 
 #include "modelsolver01-06.h"
-#include "pressurederivativecalculator.h" // 假设此文件为通用算法库，若未包含可将导数计算逻辑移入此处
+#include "besselfunctions.h"
+#include "typecurvelibrary.h"
+#include "ratesuperposition.h"
+#include "computesupport.h"
 
 #include <Eigen/Dense>
-#include <boost/math/special_functions/bessel.hpp>
 #include <cmath>
+#include <complex>
 #include <algorithm>
 #include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+// 裂缝段积分: 每个面板的 Gauss-Legendre 节点数
+static const int kQuadOrder = 16;
+// 奇异点附近面板按几何级数加密的公比
+static const double kPanelRatio = 0.2;
+// 单个面板内 |gama|*长度 的上限，保证指数型变化可被 kQuadOrder 点分辨
+static const double kMaxPanelPhase = 16.0;
+// 几何加密的最大层数
+static const int kMaxGrading = 40;
+// 储层核函数记忆表: 至少保留的储层参数组数，及每组最多记忆的取样点数
+static const int kMinReservoirEntries = 4;
+static const int kMaxReservoirSamples = 1 << 16;
+// 主曲线缓存至少保留的条数
+static const int kMinCurveEntries = 8;
+
+// 多个线程同时计算不同参数组 (种群、多起点) 时，每个线程的条目在其后续调用 (廉价变体) 之前不应被其他线程挤出，
+// 因此缓存条数不少于线程数
+static int maxReservoirEntries()
+{
+    static const int count = std::max(kMinReservoirEntries, QThread::idealThreadCount() + 1);
+    return count;
+}
+
+static int maxCurveEntries()
+{
+    static const int count = std::max(kMinCurveEntries, 2 * QThread::idealThreadCount());
+    return count;
+}
+
+// 渐近段识别: 实轴网格每个对数周期的点数，及 z ~ 1/t 两侧参与检查的网格点数 (各 1 个对数周期)
+static const int kAsymGridPerDecade = 4;
+static const int kAsymBand = 4;
+// 欧拉常数
+static const double kEulerGamma = 0.57721566490153286;
+
+// Gauss-Legendre 节点与权重 ([-1,1] 上 kQuadOrder 点)，Newton 迭代求 Legendre 多项式零点至机器精度
+struct GaussLegendreTable
+{
+    double x[kQuadOrder];
+    double w[kQuadOrder];
+
+    GaussLegendreTable()
+    {
+        const int n = kQuadOrder;
+        for (int i = 0; i < n; ++i) {
+            double xi = std::cos(M_PI * (i + 0.75) / (n + 0.5));
+            double dp = 1.0;
+            for (int iter = 0; iter < 100; ++iter) {
+                double p0 = 1.0, p1 = xi;
+                for (int k = 2; k <= n; ++k) {
+                    double p2 = ((2.0 * k - 1.0) * xi * p1 - (k - 1.0) * p0) / k;
+                    p0 = p1;
+                    p1 = p2;
+                }
+                dp = n * (xi * p1 - p0) / (xi * xi - 1.0);
+                double dx = p1 / dp;
+                xi -= dx;
+                if (std::abs(dx) < 1e-16) break;
+            }
+            x[i] = xi;
+            w[i] = 2.0 / ((1.0 - xi * xi) * dp * dp);
+        }
+    }
+};
+
+static const GaussLegendreTable& gaussLegendre()
+{
+    static const GaussLegendreTable table;
+    return table;
+}
+
+// 定节点积分面板: 距离 r 属于 [lo, hi]；singular 表示 lo = 0，需扣除 K0 的对数奇异项
+struct QuadPanel
+{
+    double lo;
+    double hi;
+    bool singular;
+};
+
+// 划分 r 属于 [r0, r1] 的积分面板 (K0 的奇异点在 r = 0)
+// 从外向内按公比 kPanelRatio 几何加密，直到最内侧面板满足: 含奇异点时 |gama|*长度 <= 1
+// (扣除奇异项后的余项为 O(r^4 ln r))，不含奇异点时长度不超过到奇异点距离的 2 倍；
+// 面板数只由几何与 |gama| 决定，不做误差估计与递归细分
+static void appendPanels(double r0, double r1, double gamaAbs, QVector<QuadPanel>& panels)
+{
+    if (r1 <= r0) return;
+    const bool singular = (r0 <= 1e-12 * r1);
+    if (singular) r0 = 0.0;
+    const double len = r1 - r0;
+
+    const double target = singular ? 1.0 / gamaAbs : 2.0 * r0;
+    int levels = 0;
+    if (len > target) {
+        levels = std::min(kMaxGrading, (int)std::ceil(std::log(len / target) / std::log(1.0 / kPanelRatio)));
+    }
+
+    double outer = len;
+    for (int k = 0; k <= levels; ++k) {
+        const double inner = (k < levels) ? outer * kPanelRatio : 0.0;
+        const double lo = r0 + inner;
+        const double hi = r0 + outer;
+        const int parts = std::max(1, (int)std::ceil(gamaAbs * (hi - lo) / kMaxPanelPhase));
+        const double step = (hi - lo) / parts;
+        for (int p = 0; p < parts; ++p) {
+            QuadPanel panel;
+            panel.lo = lo + p * step;
+            panel.hi = (p == parts - 1) ? hi : lo + (p + 1) * step;
+            panel.singular = singular && k == levels && p == 0;
+            panels.append(panel);
+        }
+        outer = inner;
+    }
+}
+
+// 完整 LU 路径中方程组阶数 (nf + 1) 不超过此值时使用栈上定长上限的 Eigen 矩阵
+static const int kFixedSystemMax = 9;
+
+// 单个拉普拉斯取样点的计算工作区: 每个取样线程各持一份 (thread_local)，容量按 nf 与积分节点数增长后
+// 反复使用 (QVector 的 resize/clear 保留容量)，拉普拉斯空间热路径上不再申请内存
+template<typename T>
+struct PWDWorkspace
+{
+    // 对偶数的 LU 只分解函数值矩阵
+    using S = typename ValueType<T>::type;
+    using MatrixT = Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic>;
+    using VectorT = Eigen::Matrix<S, Eigen::Dynamic, 1>;
+
+    // 影响系数积分
+    QVector<QuadPanel> panels;
+    QVector<double> r;
+    QVector<T> arg, k0v, i0v;
+
+    // Toeplitz 首列、右端项、解及 Levinson 递推向量
+    QVector<T> col, ones, y, f, fNew;
+
+    // 完整 LU 路径 (nf + 1 > kFixedSystemMax，或对偶数)
+    MatrixT A;
+    VectorT b, x, rhs;
+    Eigen::FullPivLU<MatrixT> lu;
+    QVector<T> system;      // 对偶数系数矩阵 (按行存放)
+};
+
+template<typename T>
+static PWDWorkspace<T>& pwdWorkspace()
+{
+    thread_local PWDWorkspace<T> ws;
+    return ws;
+}
+
+// 贝塞尔函数求值: 实数/复数直接调用 BesselFunctions；对偶数在函数值处求值后按导数关系传递偏导
+// K0' = -K1，K1' = -K0 - K1/x，(I0*e^-x)' = I1e - I0e，(I1*e^-x)' = I0e - I1e/x - I1e
+template<typename T>
+static inline void besselEvaluate(const T& x, T* k0, T* k1, T* i0e, T* i1e)
+{
+    BesselFunctions::evaluate(x, k0, k1, i0e, i1e);
+}
+
+template<typename S>
+static void besselEvaluate(const Dual<S>& x, Dual<S>* k0, Dual<S>* k1, Dual<S>* i0e, Dual<S>* i1e)
+{
+    const bool needK = k0 || k1;
+    const bool needI = i0e || i1e;
+    S vk0, vk1, vi0, vi1;
+    BesselFunctions::evaluate(x.v, needK ? &vk0 : nullptr, needK ? &vk1 : nullptr,
+                              needI ? &vi0 : nullptr, needI ? &vi1 : nullptr);
+    const S inv = S(1.0) / x.v;
+    if (k0) *k0 = Dual<S>::chain(vk0, -vk1, x);
+    if (k1) *k1 = Dual<S>::chain(vk1, -vk0 - vk1 * inv, x);
+    if (i0e) *i0e = Dual<S>::chain(vi0, vi1 - vi0, x);
+    if (i1e) *i1e = Dual<S>::chain(vi1, vi0 - vi1 * inv - vi1, x);
+}
+
+// 批量版本 (对偶数逐点求值)
+template<typename T>
+static inline void besselEvaluate(const T* x, int n, T* k0, T* k1, T* i0e, T* i1e)
+{
+    BesselFunctions::evaluate(x, n, k0, k1, i0e, i1e);
+}
+
+template<typename S>
+static void besselEvaluate(const Dual<S>* x, int n, Dual<S>* k0, Dual<S>* k1, Dual<S>* i0e, Dual<S>* i1e)
+{
+    for (int i = 0; i < n; ++i) {
+        besselEvaluate(x[i], k0 ? k0 + i : nullptr, k1 ? k1 + i : nullptr,
+                       i0e ? i0e + i : nullptr, i1e ? i1e + i : nullptr);
+    }
+}
+
+// ---------------- 模型族策略 ----------------
+// 边界策略: 给出外边界对 I0、I1 项的修正 termI0、termI1 (已乘 exp(gama2*(rmD-reD)) 缩放)
+// 参数类型 P 为 double (常规计算) 或与 T 相同的对偶数 (灵敏度计算)
+
+// 无限大边界: 无修正项
+struct InfiniteBoundary
+{
+    static constexpr ModelSolver01_06::BoundaryType boundary = ModelSolver01_06::Infinite;
+    static constexpr bool bounded = false;
+
+    template<typename T, typename P>
+    static void outerTerms(const T&, const P&, const T&, const T&, const T&, T& termI0, T& termI1)
+    {
+        termI0 = T(0.0);
+        termI1 = T(0.0);
+    }
+};
+
+// 封闭边界: 外边界无流动
+struct ClosedBoundary
+{
+    static constexpr ModelSolver01_06::BoundaryType boundary = ModelSolver01_06::Closed;
+    static constexpr bool bounded = true;
+
+    template<typename T, typename P>
+    static void outerTerms(const T& gama2, const P& reD, const T& arg_g2_rm, const T& i0_g2_s, const T& i1_g2_s,
+                           T& termI0, T& termI1)
+    {
+        using std::abs;
+        using std::exp;
+        T arg_re = gama2 * reD;
+        T k1_re, i1_re_s;
+        besselEvaluate(arg_re, (T*)nullptr, &k1_re, (T*)nullptr, &i1_re_s);
+        termI0 = T(0.0);
+        termI1 = T(0.0);
+        if (abs(i1_re_s) > 1e-100) {
+            T scale = (k1_re / i1_re_s) * exp(arg_g2_rm - arg_re);
+            termI0 = scale * i0_g2_s;
+            termI1 = scale * i1_g2_s;
+        }
+    }
+};
+
+// 定压边界: 外边界压力恒定
+struct ConstantPressureBoundary
+{
+    static constexpr ModelSolver01_06::BoundaryType boundary = ModelSolver01_06::ConstantPressure;
+    static constexpr bool bounded = true;
+
+    template<typename T, typename P>
+    static void outerTerms(const T& gama2, const P& reD, const T& arg_g2_rm, const T& i0_g2_s, const T& i1_g2_s,
+                           T& termI0, T& termI1)
+    {
+        using std::abs;
+        using std::exp;
+        T arg_re = gama2 * reD;
+        T k0_re, i0_re_s;
+        besselEvaluate(arg_re, &k0_re, (T*)nullptr, &i0_re_s, (T*)nullptr);
+        termI0 = T(0.0);
+        termI1 = T(0.0);
+        if (abs(i0_re_s) > 1e-100) {
+            T scale = -(k0_re / i0_re_s) * exp(arg_g2_rm - arg_re);
+            termI0 = scale * i0_g2_s;
+            termI1 = scale * i1_g2_s;
+        }
+    }
+};
+
+// 井储策略: 在不含井储的解 pf 上叠加井储与表皮 (Params 为 ModelParams 或 SensitivityParams)
+
+// 变井储: pwD = (z*pf + S) / (z + cD*z^2*(z*pf + S))，cD = S = 0 时退化为 pf
+struct VariableStorage
+{
+    static constexpr bool hasStorage = true;
+
+    template<typename T, typename Params>
+    static T apply(const T& z, const T& pf, const Params& p)
+    {
+        T num = z * pf + p.S;
+        return num / (z + p.cD * z * z * num);
+    }
+
+    // 仅有表皮而无井储时 flaplace 含 S/z 项，初值为 S
+    template<typename Params>
+    static auto initialValue(const Params& p) -> typename std::decay<decltype(p.S)>::type
+    {
+        using P = typename std::decay<decltype(p.S)>::type;
+        return (valueOf(p.cD) <= 1e-12 && std::abs(valueOf(p.S)) > 1e-12) ? p.S : P(0.0);
+    }
+};
+
+// 恒定井储: 不修正
+struct NoStorage
+{
+    static constexpr bool hasStorage = false;
+
+    template<typename T, typename Params>
+    static T apply(const T&, const T& pf, const Params&) { return pf; }
+
+    template<typename Params>
+    static auto initialValue(const Params& p) -> typename std::decay<decltype(p.S)>::type
+    {
+        return typename std::decay<decltype(p.S)>::type(0.0);
+    }
+};
+
+// 模型 = 边界策略 × 井储策略
+template<typename BoundaryPolicy, typename StoragePolicy>
+struct CompositeModel
+{
+    using Boundary = BoundaryPolicy;
+    using Storage = StoragePolicy;
+};
+
+// 渐近形式及其原函数:
+// 幂律   F = A*z^-(1+alpha)      -> f = A*t^alpha/Gamma(1+alpha)  (井储 alpha=1，线性流 1/2，双线性流 1/4)
+// 对数   z*F = a - b*ln(z)       -> f = a + b*(ln(t) + gamma)      (径向流；b = 0 为定压边界稳态)
+// 拟稳态 z^2*F = c + d*z         -> f = c*t + d                     (封闭边界)
+struct AsymptoticFit
+{
+    enum Kind { None, PowerLaw, Logarithmic, PseudoSteady };
+    Kind kind = None;
+    double a = 0.0;         // A / a / c
+    double b = 0.0;         // alpha / b / d
+    double error = 0.0;     // 检查带内拉普拉斯空间的最大相对偏差
+
+    double value(double t) const
+    {
+        switch (kind) {
+        case PowerLaw: return a * std::pow(t, b) / std::tgamma(1.0 + b);
+        case Logarithmic: return a + b * (std::log(t) + kEulerGamma);
+        case PseudoSteady: return a * t + b;
+        default: return 0.0;
+        }
+    }
+
+    // t*df/dt
+    double logDerivative(double t) const
+    {
+        switch (kind) {
+        case PowerLaw: return b * value(t);
+        case Logarithmic: return b;
+        case PseudoSteady: return a * t;
+        default: return 0.0;
+        }
+    }
+
+    QString regime() const
+    {
+        switch (kind) {
+        case PowerLaw:
+            if (std::abs(b - 1.0) < 0.05) return "井储 (单位斜率)";
+            if (std::abs(b - 0.5) < 0.05) return "线性流";
+            if (std::abs(b - 0.25) < 0.05) return "双线性流";
+            return "幂律 (斜率 " + QString::number(b, 'f', 2) + ")";
+        case Logarithmic: return (std::abs(b) <= 1e-3 * std::abs(a)) ? "稳态" : "径向流";
+        case PseudoSteady: return "拟稳态";
+        default: return QString();
+        }
+    }
+};
+
+// 在 z = 10^(k/kAsymGridPerDecade) 的实轴网格上取样 (同一次反演内复用)，对时间点 t 取 z ~ 1/t 两侧
+// 各 kAsymBand 个网格点: 用两端点确定渐近形式的参数，再检查带内所有网格点的相对偏差
+class AsymptoticScanner
+{
+public:
+    AsymptoticScanner(const LaplaceInversion::RealKernel& F, double tol) : m_F(F), m_tol(tol) {}
+
+    // 早期 (大 z): 幂律
+    bool early(double t, AsymptoticFit& fit)
+    {
+        int lo, hi;
+        if (!band(t, lo, hi)) return false;
+        const double zl = z(lo), zh = z(hi), zc = z((lo + hi) / 2);
+        const double alpha = -std::log(F(hi) / F(lo)) / std::log(zh / zl) - 1.0;
+        if (!(alpha >= 0.0 && alpha <= 2.0)) return false;
+        const double A = F((lo + hi) / 2) * std::pow(zc, 1.0 + alpha);
+        fit.error = check(lo, hi, [&](double x) { return A * std::pow(x, -(1.0 + alpha)); });
+        if (!(fit.error <= m_tol)) return false;
+        fit.kind = AsymptoticFit::PowerLaw;
+        fit.a = A;
+        fit.b = alpha;
+        return true;
+    }
+
+    // 晚期 (小 z): 对数或拟稳态，取偏差较小者
+    bool late(double t, AsymptoticFit& fit)
+    {
+        int lo, hi;
+        if (!band(t, lo, hi)) return false;
+        const double zl = z(lo), zh = z(hi), zc = z((lo + hi) / 2);
+
+        AsymptoticFit logFit;
+        logFit.kind = AsymptoticFit::Logarithmic;
+        logFit.b = -(zh * F(hi) - zl * F(lo)) / std::log(zh / zl);
+        logFit.a = zl * F(lo) + logFit.b * std::log(zl);
+        logFit.error = check(lo, hi, [&](double x) { return (logFit.a - logFit.b * std::log(x)) / x; });
+
+        AsymptoticFit pssFit;
+        pssFit.kind = AsymptoticFit::PseudoSteady;
+        pssFit.b = (zh * zh * F(hi) - zl * zl * F(lo)) / (zh - zl);
+        pssFit.a = zl * zl * F(lo) - pssFit.b * zl;
+        pssFit.error = check(lo, hi, [&](double x) { return (pssFit.a + pssFit.b * x) / (x * x); });
+        // c*t 项可忽略时即为稳态，按对数形式处理
+        const bool pssValid = pssFit.a > m_tol * std::abs(pssFit.b) * zc && pssFit.error <= m_tol;
+        const bool logValid = logFit.b >= 0.0 && logFit.error <= m_tol;
+
+        if (pssValid && (!logValid || pssFit.error < logFit.error)) fit = pssFit;
+        else if (logValid) fit = logFit;
+        else return false;
+        return true;
+    }
+
+    int kernelCalls() const { return m_samples.size(); }
+
+private:
+    double z(int k) const { return std::pow(10.0, double(k) / kAsymGridPerDecade); }
+
+    double F(int k)
+    {
+        auto it = m_samples.constFind(k);
+        if (it != m_samples.constEnd()) return it.value();
+        double v = m_F(z(k));
+        m_samples.insert(k, v);
+        return v;
+    }
+
+    // 检查带 [lo, hi]，带内取样须为有限正值
+    bool band(double t, int& lo, int& hi)
+    {
+        const int center = (int)std::lround(-std::log10(t) * kAsymGridPerDecade);
+        lo = center - kAsymBand;
+        hi = center + kAsymBand;
+        for (int k = lo; k <= hi; ++k) {
+            double v = F(k);
+            if (!(v > 0.0) || std::isinf(v)) return false;
+        }
+        return true;
+    }
+
+    template<typename Form>
+    double check(int lo, int hi, const Form& form)
+    {
+        double err = 0.0;
+        for (int k = lo; k <= hi; ++k) {
+            double e = std::abs(form(z(k)) / F(k) - 1.0);
+            if (!(e <= err)) err = e;   // NaN 视为不满足
+        }
+        return err;
+    }
+
+    const LaplaceInversion::RealKernel& m_F;
+    double m_tol;
+    QMap<int, double> m_samples;
+};
+
+template<typename Model>
+ModelSolver01_06::ModelKernel ModelSolver01_06::makeKernel(ModelType type, const char* name)
+{
+    ModelKernel k;
+    k.type = type;
+    k.name = name;
+    k.boundary = Model::Boundary::boundary;
+    k.bounded = Model::Boundary::bounded;
+    k.hasStorage = Model::Storage::hasStorage;
+    k.laplaceReal = &ModelSolver01_06::flaplace_composite<Model, double, ModelParams>;
+    k.laplaceComplex = &ModelSolver01_06::flaplace_composite<Model, std::complex<double>, ModelParams>;
+    k.initialValue = &Model::Storage::template initialValue<ModelParams>;
+    k.reservoirReal = &ModelSolver01_06::reservoir_composite<Model, double, ModelParams>;
+    k.reservoirComplex = &ModelSolver01_06::reservoir_composite<Model, std::complex<double>, ModelParams>;
+    k.storageReal = &ModelSolver01_06::storage_composite<Model, double, ModelParams>;
+    k.storageComplex = &ModelSolver01_06::storage_composite<Model, std::complex<double>, ModelParams>;
+    k.laplaceRealDual = &ModelSolver01_06::flaplace_composite<Model, RealDual, SensitivityParams<RealDual>>;
+    k.laplaceComplexDual = &ModelSolver01_06::flaplace_composite<Model, ComplexDual, SensitivityParams<ComplexDual>>;
+    k.initialValueDual = &Model::Storage::template initialValue<SensitivityParams<RealDual>>;
+    return k;
+}
+
+// 模型注册表 (新增模型: 在枚举中加入类型，并在此处注册其策略组合)
+const QVector<ModelSolver01_06::ModelKernel>& ModelSolver01_06::modelRegistry()
+{
+    static const QVector<ModelKernel> registry = {
+        makeKernel<CompositeModel<InfiniteBoundary, VariableStorage>>(Model_1, "模型1: 变井储+无限大边界"),
+        makeKernel<CompositeModel<InfiniteBoundary, NoStorage>>(Model_2, "模型2: 恒定井储+无限大边界"),
+        makeKernel<CompositeModel<ClosedBoundary, VariableStorage>>(Model_3, "模型3: 变井储+封闭边界"),
+        makeKernel<CompositeModel<ClosedBoundary, NoStorage>>(Model_4, "模型4: 恒定井储+封闭边界"),
+        makeKernel<CompositeModel<ConstantPressureBoundary, VariableStorage>>(Model_5, "模型5: 变井储+定压边界"),
+        makeKernel<CompositeModel<ConstantPressureBoundary, NoStorage>>(Model_6, "模型6: 恒定井储+定压边界")
+    };
+    return registry;
+}
+
 // 构造函数
 ModelSolver01_06::ModelSolver01_06(ModelType type)
     : m_type(type)
-    , m_highPrecision(true)
+    , m_kernel(&modelKernel(type))
 {
 }
 
@@ -35,21 +525,98 @@ ModelSolver01_06::~ModelSolver01_06()
 // 设置精度
 void ModelSolver01_06::setHighPrecision(bool high)
 {
-    m_highPrecision = high;
+    m_options.highPrecision = high;
+}
+
+// 设置反演算法
+void ModelSolver01_06::setInversionMethod(LaplaceInversion::Method method, int order)
+{
+    m_options.inversionMethod = method;
+    m_options.inversionOrder = order;
+}
+
+// 设置反演取样线程数
+void ModelSolver01_06::setThreadCount(int count)
+{
+    m_options.threadCount = count;
+}
+
+// 设置 Stehfest 自适应选阶容差
+void ModelSolver01_06::setInversionTolerance(double tol)
+{
+    m_options.inversionTolerance = std::max(0.0, tol);
+}
+
+// 设置渐近段捷径容差
+void ModelSolver01_06::setAsymptoticTolerance(double tol)
+{
+    m_options.asymptoticTolerance = std::max(0.0, tol);
+}
+
+// 设置类型曲线库
+void ModelSolver01_06::setTypeCurveLibrary(const TypeCurveLibrary* library)
+{
+    m_options.typeCurveLibrary = library;
+}
+
+// 最近一次统计 (旧接口)
+LaplaceInversion::Report ModelSolver01_06::lastInversionReport() const
+{
+    QMutexLocker locker(&m_reportMutex);
+    return m_lastReport.inversion;
+}
+
+ModelSolver01_06::AsymptoticReport ModelSolver01_06::lastAsymptoticReport() const
+{
+    QMutexLocker locker(&m_reportMutex);
+    return m_lastReport.asymptotic;
+}
+
+void ModelSolver01_06::storeLastReport(const Report& report)
+{
+    QMutexLocker locker(&m_reportMutex);
+    m_lastReport = report;
+}
+
+// 选项键: 曲线结果除参数与时间点外只取决于这些选项
+QVector<double> SolverOptions::key() const
+{
+    QVector<double> key;
+    key.reserve(6);
+    key << (highPrecision ? 1.0 : 0.0)
+        << double(inversionMethod)
+        << double(inversionOrder)
+        << inversionTolerance
+        << asymptoticTolerance
+        << (cacheEnabled ? 1.0 : 0.0);
+    return key;
 }
 
 // 获取模型名称
 QString ModelSolver01_06::getModelName(ModelType type)
 {
-    switch(type) {
-    case Model_1: return "模型1: 变井储+无限大边界";
-    case Model_2: return "模型2: 恒定井储+无限大边界";
-    case Model_3: return "模型3: 变井储+封闭边界";
-    case Model_4: return "模型4: 恒定井储+封闭边界";
-    case Model_5: return "模型5: 变井储+定压边界";
-    case Model_6: return "模型6: 恒定井储+定压边界";
-    default: return "未知模型";
+    for (const ModelKernel& k : modelRegistry()) {
+        if (k.type == type) return QString::fromUtf8(k.name);
+    }
+    return "未知模型";
+}
+
+// 全部已注册的模型类型
+QVector<ModelSolver01_06::ModelType> ModelSolver01_06::registeredModels()
+{
+    QVector<ModelType> types;
+    for (const ModelKernel& k : modelRegistry()) types.append(k.type);
+    return types;
+}
+
+// 查询模型注册表项
+const ModelSolver01_06::ModelKernel& ModelSolver01_06::modelKernel(ModelType type)
+{
+    const QVector<ModelKernel>& registry = modelRegistry();
+    for (const ModelKernel& k : registry) {
+        if (k.type == type) return k;
     }
+    return registry.first();
 }
 
 // 生成对数时间步长
@@ -65,9 +632,135 @@ QVector<double> ModelSolver01_06::generateLogTimeSteps(int count, double startEx
     return t;
 }
 
-// 核心计算函数
+// 从参数表解析参数块
+ModelParams ModelParams::fromMap(const QMap<QString, double>& p)
+{
+    ModelParams mp;
+    mp.phi = p.value("phi", mp.phi);
+    mp.mu = p.value("mu", mp.mu);
+    mp.B = p.value("B", mp.B);
+    mp.Ct = p.value("Ct", mp.Ct);
+    mp.q = p.value("q", mp.q);
+    mp.h = p.value("h", mp.h);
+    mp.L = p.value("L", mp.L);
+
+    mp.kf = p.value("kf", mp.kf);
+    mp.km = p.value("km", mp.km);
+    mp.LfD = p.value("LfD", mp.LfD);
+    mp.rmD = p.value("rmD", mp.rmD);
+    mp.reD = p.value("reD", mp.reD);
+    mp.omega1 = p.value("omega1", mp.omega1);
+    mp.omega2 = p.value("omega2", mp.omega2);
+    mp.lambda1 = p.value("lambda1", mp.lambda1);
+    mp.nf = std::max(1, (int)p.value("nf", mp.nf));
+    mp.cD = p.value("cD", mp.cD);
+    mp.S = p.value("S", mp.S);
+    mp.gamaD = p.value("gamaD", mp.gamaD);
+    mp.N = (int)p.value("N", mp.N);
+
+    mp.updateDerived();
+    return mp;
+}
+
+// 计算派生量: 导流比 M12 与裂缝位置 xwD (在 [-0.9, 0.9] 上均匀分布)
+void ModelParams::updateDerived()
+{
+    if (nf < 1) nf = 1;
+    M12 = kf / km;
+
+    xwD.resize(nf);
+    if (nf == 1) {
+        xwD[0] = 0.0;
+    } else {
+        double start = -0.9;
+        double end = 0.9;
+        double step = (end - start) / (nf - 1);
+        for(int i=0; i<nf; ++i) xwD[i] = start + i * step;
+    }
+}
+
+// 参数合法性检查 (封闭/定压边界需 reD > rmD)；精确计算不做检查，与原接口一致，只用于判断能否使用类型曲线库
+bool ModelParams::isValid(bool bounded, QString* error) const
+{
+    auto fail = [error](const QString& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+    if (!(phi > 0.0) || !(mu > 0.0) || !(B > 0.0) || !(Ct > 0.0) || !(h > 0.0) || !(L > 0.0))
+        return fail("phi、mu、B、Ct、h、L 必须为正数");
+    if (!(kf > 0.0) || !(km > 0.0)) return fail("kf、km 必须为正数");
+    if (!(LfD > 0.0) || !(rmD > 0.0)) return fail("LfD、rmD 必须为正数");
+    if (!(omega2 > 0.0)) return fail("omega2 必须为正数");
+    if (!(omega1 >= 0.0) || !(lambda1 >= 0.0)) return fail("omega1、lambda1 不能为负");
+    if (bounded && !(reD > rmD)) return fail("边界半径 reD 必须大于复合半径 rmD");
+    if (cD < 0.0) return fail("井储系数 cD 不能为负");
+    return true;
+}
+
+// 旧接口: 以默认选项调用可重入接口，并记录统计
 ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
 {
+    return calculateTheoreticalCurve(ModelParams::fromMap(params), providedTime);
+}
+
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const ModelParams& params, const QVector<double>& providedTime)
+{
+    Report report;
+    ModelCurveData curve = calculateTheoreticalCurve(params, providedTime, m_options, &report);
+    storeLastReport(report);
+    return curve;
+}
+
+ModelCurveData ModelSolver01_06::calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime)
+{
+    return calculatePreviewCurve(ModelParams::fromMap(params), providedTime, m_options);
+}
+
+ModelCurveData ModelSolver01_06::calculatePreviewCurve(const ModelParams& params, const QVector<double>& providedTime)
+{
+    return calculatePreviewCurve(params, providedTime, m_options);
+}
+
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD)
+{
+    return calculateDimensionlessCurve(ModelParams::fromMap(params), tD);
+}
+
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(const ModelParams& params, const QVector<double>& tD)
+{
+    Report report;
+    ModelCurveData curve = calculateDimensionlessCurve(params, tD, m_options, &report);
+    storeLastReport(report);
+    return curve;
+}
+
+CurveSensitivity ModelSolver01_06::calculateSensitivities(const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names)
+{
+    return calculateSensitivities(ModelParams::fromMap(params), t, names);
+}
+
+CurveSensitivity ModelSolver01_06::calculateSensitivities(const ModelParams& params, const QVector<double>& t, const QStringList& names)
+{
+    Report report;
+    CurveSensitivity result = calculateSensitivities(params, t, names, m_options, &report);
+    storeLastReport(report);
+    return result;
+}
+
+// 核心计算函数 (可重入)
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                           const SolverOptions& options, Report* report) const
+{
+    return calculateTheoreticalCurve(ModelParams::fromMap(params), providedTime, options, report);
+}
+
+ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const ModelParams& params, const QVector<double>& providedTime,
+                                                           const SolverOptions& options, Report* report) const
+{
+    Report localReport;
+    Report& rep = report ? *report : localReport;
+    rep = Report();
+
     // 1. 准备时间序列
     QVector<double> tPoints = providedTime;
     if (tPoints.isEmpty()) {
@@ -75,14 +768,14 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     }
 
     // 2. 提取物理参数
-    double phi = params.value("phi", 0.05);
-    double mu = params.value("mu", 0.5);
-    double B = params.value("B", 1.05);
-    double Ct = params.value("Ct", 5e-4);
-    double q = params.value("q", 5.0);
-    double h = params.value("h", 20.0);
-    double kf = params.value("kf", 1e-3);
-    double L = params.value("L", 1000.0);
+    double phi = params.phi;
+    double mu = params.mu;
+    double B = params.B;
+    double Ct = params.Ct;
+    double q = params.q;
+    double h = params.h;
+    double kf = params.kf;
+    double L = params.L;
 
     // 3. 计算无因次时间 tD
     QVector<double> tD_vec;
@@ -99,9 +792,13 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     }
 
     // 4. 计算无因次压力和导数
+    // phi、Ct、L 等只改变 td_coeff，缓存开启时从无因次主曲线插值，不重新反演
     QVector<double> PD_vec, Deriv_vec;
-    auto func = std::bind(&ModelSolver01_06::flaplace_composite, this, std::placeholders::_1, std::placeholders::_2);
-    calculatePDandDeriv(tD_vec, params, func, PD_vec, Deriv_vec);
+    if (options.cacheEnabled) {
+        interpolatePDandDeriv(tD_vec, params, options, rep, PD_vec, Deriv_vec);
+    } else {
+        calculatePDandDeriv(tD_vec, params, options, rep, PD_vec, Deriv_vec);
+    }
 
     // 5. 将无因次量转换为物理量 (压差 dp)
     // dp = 1.842e-3 * q * mu * B / (k * h) * pD
@@ -117,231 +814,1045 @@ ModelCurveData ModelSolver01_06::calculateTheoreticalCurve(const QMap<QString, d
     return std::make_tuple(tPoints, finalP, finalDP);
 }
 
-// Stehfest 数值反演计算 PD 和导数
-void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                                           std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                                           QVector<double>& outPD, QVector<double>& outDeriv)
+// 变产量曲线 (单位产量响应 + 快速叠加)
+ModelCurveData ModelSolver01_06::calculateVariableRateCurve(const QMap<QString, double>& params, const QVector<double>& t,
+                                                            const RateSuperposition& history, const SolverOptions& options,
+                                                            Report* report) const
+{
+    return calculateVariableRateCurve(ModelParams::fromMap(params), t, history, options, report);
+}
+
+ModelCurveData ModelSolver01_06::calculateVariableRateCurve(const ModelParams& params, const QVector<double>& t,
+                                                            const RateSuperposition& history, const SolverOptions& options,
+                                                            Report* report) const
+{
+    if (report) *report = Report();
+
+    // 没有时刻位于第一次产量变化之后: 压差恒为 0
+    double tauMin = 0.0, tauMax = 0.0;
+    if (!history.responseRange(t, tauMin, tauMax)) {
+        QVector<double> zero(t.size(), 0.0);
+        return std::make_tuple(t, zero, zero);
+    }
+
+    // 单位产量 (q = 1) 的定产曲线，只在叠加所需的 tau 范围内计算一次
+    ModelParams unitParams = params;
+    unitParams.q = 1.0;
+    const QVector<double> grid = RateSuperposition::responseGrid(tauMin, tauMax);
+    ModelCurveData unitCurve = calculateTheoreticalCurve(unitParams, grid, options, report);
+
+    RateSuperposition::UnitResponse unit(grid, std::get<1>(unitCurve), std::get<2>(unitCurve));
+    return history.superpose(unit, t);
+}
+
+// 预览曲线 (类型曲线库插值)
+ModelCurveData ModelSolver01_06::calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                                       const SolverOptions& options) const
+{
+    return calculatePreviewCurve(ModelParams::fromMap(params), providedTime, options);
+}
+
+ModelCurveData ModelSolver01_06::calculatePreviewCurve(const ModelParams& params, const QVector<double>& providedTime,
+                                                       const SolverOptions& options) const
+{
+    if (!options.typeCurveLibrary || !params.isValid(m_kernel->bounded)) {
+        return calculateTheoreticalCurve(params, providedTime, options);
+    }
+
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+
+    // 时间与压力的换算与 calculateTheoreticalCurve 相同
+    const double td_coeff = 14.4 * params.kf / (params.phi * params.mu * params.Ct * pow(params.L, 2));
+    QVector<double> tD_vec(tPoints.size());
+    for (int i = 0; i < tPoints.size(); ++i) tD_vec[i] = td_coeff * tPoints[i];
+
+    QVector<double> PD_vec, Deriv_vec;
+    if (!previewPDandDeriv(tD_vec, params, options.typeCurveLibrary, PD_vec, Deriv_vec)) {
+        return calculateTheoreticalCurve(params, tPoints, options);
+    }
+    applyPressureSensitivity(tD_vec, params.gamaD, PD_vec, Deriv_vec);
+
+    const double p_coeff = 1.842e-3 * params.q * params.mu * params.B / (params.kf * params.h);
+    QVector<double> finalP(tPoints.size()), finalDP(tPoints.size());
+    for (int i = 0; i < tPoints.size(); ++i) {
+        finalP[i] = p_coeff * PD_vec[i];
+        finalDP[i] = p_coeff * Deriv_vec[i];
+    }
+    return std::make_tuple(tPoints, finalP, finalDP);
+}
+
+// 由类型曲线库插值 pf(z) 后做 Stehfest 反演 (不经过缓存，不输出反演统计)
+bool ModelSolver01_06::previewPDandDeriv(const QVector<double>& tD, const ModelParams& params, const TypeCurveLibrary* library,
+                                         QVector<double>& outPD, QVector<double>& outDeriv) const
 {
-    int numPoints = tD.size();
-    outPD.resize(numPoints);
-    outDeriv.resize(numPoints);
+    // 库中的 ln(pf) 为单精度且在 z 方向分段插值，Stehfest 阶数越高对这类误差放大越多，预览固定取低阶
+    static const int kPreviewOrder = 6;
 
-    int N_param = (int)params.value("N", 4);
-    int N = m_highPrecision ? N_param : 4;
-    if (N % 2 != 0) N = 4;
-    double ln2 = log(2.0);
+    if (!library || !library->isOpen()) return false;
 
-    double gamaD = params.value("gamaD", 0.0);
+    // Stehfest 取样点 z = i*ln2/tD (i = 1..N) 的范围
+    double tMin = 0.0, tMax = 0.0;
+    bool any = false;
+    for (double t : tD) {
+        if (t <= 1e-12) continue;
+        if (!any) { tMin = tMax = t; any = true; }
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    if (!any) return false;
+    const double ln2 = std::log(2.0);
+    const double zLo = ln2 / tMax;
+    const double zHi = kPreviewOrder * ln2 / tMin;
+    const TypeCurveLibrary::Query query = library->prepare(m_kernel->boundary, params, zLo, zHi);
+    if (!query.isValid()) return false;
 
-    for (int k = 0; k < numPoints; ++k) {
-        double t = tD[k];
-        if (t <= 1e-12) { outPD[k] = 0; continue; }
+    LaplaceInversion inversion(LaplaceInversion::Stehfest, kPreviewOrder);
+    inversion.setThreadCount(1);
+    inversion.setInitialValue(m_kernel->initialValue(params));
+
+    // 库的 z 范围以外 (或该处网格节点溢出) 的取样点直接计算储层解
+    const ModelKernel* kernel = m_kernel;
+    auto realKernel = [kernel, &query, &params](double z) {
+        double pf = query(z);
+        if (!std::isfinite(pf)) pf = kernel->reservoirReal(z, params);
+        return kernel->storageReal(z, pf, params);
+    };
+    outPD = inversion.invert(tD, realKernel, LaplaceInversion::ComplexKernel(), nullptr, &outDeriv);
+    return true;
+}
 
-        double pd_val = 0.0;
-        for (int m = 1; m <= N; ++m) {
-            double z = m * ln2 / t;
-            double pf = laplaceFunc(z, params);
-            if (std::isnan(pf) || std::isinf(pf)) pf = 0.0;
-            pd_val += stefestCoefficient(m, N) * pf;
+// 无因次曲线计算 (不经过缓存)
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD,
+                                                             const SolverOptions& options, Report* report) const
+{
+    return calculateDimensionlessCurve(ModelParams::fromMap(params), tD, options, report);
+}
+
+ModelCurveData ModelSolver01_06::calculateDimensionlessCurve(const ModelParams& params, const QVector<double>& tD,
+                                                             const SolverOptions& options, Report* report) const
+{
+    Report localReport;
+    Report& rep = report ? *report : localReport;
+    rep = Report();
+    QVector<double> PD_vec, Deriv_vec;
+    calculatePDandDeriv(tD, params, options, rep, PD_vec, Deriv_vec);
+    return std::make_tuple(tD, PD_vec, Deriv_vec);
+}
+
+// 参数灵敏度 (前向自动微分)
+CurveSensitivity ModelSolver01_06::calculateSensitivities(const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names,
+                                                          const SolverOptions& options, Report* report) const
+{
+    return calculateSensitivities(ModelParams::fromMap(params), t, names, options, report);
+}
+
+// 进入拉普拉斯空间的参数各占一个对偶数方向；tD = c*t 中的 ln c 另占一个时间尺度方向:
+// pD(c*t) 的像函数为 F(s/c)/c，在 c = 1 处对 ln c 的偏导为 -(F + s*F')，由 z 的种子 dz = -z 加上 -F 得到。
+// phi、mu、Ct、L、kf 经 c 影响曲线，q、mu、B、kf、h 经压力系数影响曲线，gamaD 在反演后解析求导
+CurveSensitivity ModelSolver01_06::calculateSensitivities(const ModelParams& params, const QVector<double>& providedTime, const QStringList& names,
+                                                          const SolverOptions& options, Report* report) const
+{
+    enum Direction { DirM12, DirLfD, DirRmD, DirReD, DirOmega1, DirOmega2, DirLambda1, DirCD, DirS, DirScale, DirCount };
+    static_assert(DirCount <= RealDual::kMaxDirections, "too many sensitivity directions");
+    static_assert(DirCount + 1 <= LaplaceInversion::kMaxChannels, "too many inversion channels");
+
+    if (report) *report = Report();
+    CurveSensitivity result;
+    result.names = names;
+    QVector<double> tPoints = providedTime;
+    if (tPoints.isEmpty()) {
+        tPoints = generateLogTimeSteps(100, -3.0, 3.0);
+    }
+    const int numPoints = tPoints.size();
+    result.dP = QVector<QVector<double>>(names.size(), QVector<double>(numPoints, 0.0));
+    result.dDeriv = result.dP;
+
+    // 1. 需要的方向
+    bool needed[DirCount] = {};
+    for (const QString& name : names) {
+        if (name == "kf") { needed[DirM12] = true; needed[DirScale] = true; }
+        else if (name == "km") needed[DirM12] = true;
+        else if (name == "LfD") needed[DirLfD] = true;
+        else if (name == "rmD") needed[DirRmD] = true;
+        else if (name == "reD") needed[DirReD] = m_kernel->bounded;
+        else if (name == "omega1") needed[DirOmega1] = true;
+        else if (name == "omega2") needed[DirOmega2] = true;
+        else if (name == "lambda1") needed[DirLambda1] = true;
+        else if (name == "cD") needed[DirCD] = m_kernel->hasStorage;
+        else if (name == "S") needed[DirS] = m_kernel->hasStorage;
+        else if (name == "phi" || name == "mu" || name == "Ct" || name == "L") needed[DirScale] = true;
+    }
+    int index[DirCount];
+    int count = 0;
+    for (int k = 0; k < DirCount; ++k) index[k] = needed[k] ? count++ : -1;
+
+    // 2. 播种参数块
+    auto seed = [&](auto& sp) {
+        using P = typename std::decay<decltype(sp.M12)>::type;
+        auto var = [&](double value, int dir) { return index[dir] >= 0 ? P::variable(value, index[dir], count) : P(value); };
+        sp.M12 = var(params.M12, DirM12);
+        sp.LfD = var(params.LfD, DirLfD);
+        sp.rmD = var(params.rmD, DirRmD);
+        sp.reD = var(params.reD, DirReD);
+        sp.omega1 = var(params.omega1, DirOmega1);
+        sp.omega2 = var(params.omega2, DirOmega2);
+        sp.lambda1 = var(params.lambda1, DirLambda1);
+        sp.cD = var(params.cD, DirCD);
+        sp.S = var(params.S, DirS);
+        sp.nf = params.nf;
+        sp.xwD = params.xwD;
+    };
+    SensitivityParams<RealDual> realParams;
+    SensitivityParams<ComplexDual> complexParams;
+    seed(realParams);
+    seed(complexParams);
+
+    // 3. 多通道反演: 通道 0 为 pD，通道 1+k 为第 k 个方向的偏导
+    const ModelKernel* kernel = m_kernel;
+    const int scaleDir = index[DirScale];
+    auto channelKernel = [kernel, count, scaleDir](auto z, auto* out, auto laplace, const auto& sp) {
+        using D = typename std::decay<decltype(sp.M12)>::type;
+        D zd(z);
+        if (scaleDir >= 0) {
+            zd = D::variable(z, scaleDir, count);
+            zd.d[scaleDir] = -z;
         }
-        outPD[k] = pd_val * ln2 / t;
+        D F = laplace(zd, sp);
+        out[0] = F.v;
+        for (int k = 0; k < count; ++k) out[1 + k] = F.derivative(k);
+        if (scaleDir >= 0) out[1 + scaleDir] -= F.v;
+    };
+    auto realKernel = [&](double z, double* out) {
+        channelKernel(z, out, kernel->laplaceRealDual, realParams);
+    };
+    auto complexKernel = [&](const std::complex<double>& z, std::complex<double>* out) {
+        channelKernel(z, out, kernel->laplaceComplexDual, complexParams);
+    };
 
-        // 考虑压敏效应修正
+    const RealDual f0 = kernel->initialValueDual(realParams);
+    QVector<double> initial(1 + count, 0.0);
+    initial[0] = f0.v;
+    for (int k = 0; k < count; ++k) initial[1 + k] = f0.derivative(k);
+
+    // 物理量换算 (与 calculateTheoreticalCurve 一致)
+    const double td_coeff = 14.4 * params.kf / (params.phi * params.mu * params.Ct * pow(params.L, 2));
+    const double p_coeff = 1.842e-3 * params.q * params.mu * params.B / (params.kf * params.h);
+    QVector<double> tD(numPoints);
+    for (int i = 0; i < numPoints; ++i) tD[i] = td_coeff * tPoints[i];
+
+    LaplaceInversion inversion(options.inversionMethod, resolveInversionOrder(params, options));
+    inversion.setThreadCount(options.threadCount);
+    inversion.setTolerance(options.inversionTolerance);
+    QVector<QVector<double>> derivs;
+    LaplaceInversion::Report inversionReport;
+    const QVector<QVector<double>> values = inversion.invertChannels(tD, 1 + count, realKernel, complexKernel,
+                                                                     initial, &inversionReport, &derivs);
+    if (report) report->inversion = inversionReport;
+
+    // 4. 压敏修正及其链式法则，换算为物理量
+    QVector<double> finalP(numPoints, 0.0), finalDP(numPoints, 0.0);
+    QVector<double> dirP(count), dirD(count);
+    const double gamaD = params.gamaD;
+    for (int i = 0; i < numPoints; ++i) {
+        if (tD[i] <= 1e-12) continue;
+        const double pD = values[0][i];
+        const double D = derivs[0][i];
+        double P = pD, Dv = D, gamP = 0.0, gamD = 0.0;
+        for (int k = 0; k < count; ++k) {
+            dirP[k] = values[1 + k][i];
+            dirD[k] = derivs[1 + k][i];
+        }
+        const double arg = 1.0 - gamaD * pD;
         if (std::abs(gamaD) > 1e-9) {
-            double arg = 1.0 - gamaD * outPD[k];
             if (arg > 1e-12) {
-                outPD[k] = -1.0 / gamaD * std::log(arg);
+                // pD' = -ln(arg)/gamaD，dpD' = dpD/arg，D' = D/arg
+                P = -1.0 / gamaD * std::log(arg);
+                Dv = D / arg;
+                gamP = std::log(arg) / (gamaD * gamaD) + pD / (gamaD * arg);
+                gamD = D * pD / (arg * arg);
+                for (int k = 0; k < count; ++k) {
+                    dirD[k] = dirD[k] / arg + D * gamaD * dirP[k] / (arg * arg);
+                    dirP[k] = dirP[k] / arg;
+                }
             }
+        } else {
+            // gamaD -> 0 的极限: pD' = pD + gamaD*pD^2/2 + ...
+            gamP = 0.5 * pD * pD;
+            gamD = D * pD;
         }
-    }
 
-    // 计算导数 (Bourdet 导数)
-    if (numPoints > 2) {
-        // 依赖外部库 PressureDerivativeCalculator
-        outDeriv = PressureDerivativeCalculator::calculateBourdetDerivative(tD, outPD, 0.1);
-    } else {
-        outDeriv.fill(0.0);
+        const double p = p_coeff * P;
+        const double dp = p_coeff * Dv;
+        finalP[i] = p;
+        finalDP[i] = dp;
+
+        auto lap = [&](int dir, double factor, double& outP, double& outD) {
+            if (index[dir] < 0) return;
+            outP += factor * p_coeff * dirP[index[dir]];
+            outD += factor * p_coeff * dirD[index[dir]];
+        };
+        for (int j = 0; j < names.size(); ++j) {
+            const QString& name = names[j];
+            double sP = 0.0, sD = 0.0;
+            if (name == "kf") {
+                lap(DirM12, 1.0 / params.km, sP, sD);
+                lap(DirScale, 1.0 / params.kf, sP, sD);
+                sP -= p / params.kf;
+                sD -= dp / params.kf;
+            } else if (name == "km") {
+                lap(DirM12, -params.kf / (params.km * params.km), sP, sD);
+            } else if (name == "phi") {
+                lap(DirScale, -1.0 / params.phi, sP, sD);
+            } else if (name == "mu") {
+                lap(DirScale, -1.0 / params.mu, sP, sD);
+                sP += p / params.mu;
+                sD += dp / params.mu;
+            } else if (name == "Ct") {
+                lap(DirScale, -1.0 / params.Ct, sP, sD);
+            } else if (name == "L") {
+                lap(DirScale, -2.0 / params.L, sP, sD);
+            } else if (name == "q" || name == "B" || name == "h") {
+                double v = (name == "q") ? params.q : (name == "B") ? params.B : -params.h;
+                sP = p / v;
+                sD = dp / v;
+            } else if (name == "gamaD") {
+                sP = p_coeff * gamP;
+                sD = p_coeff * gamD;
+            } else if (name == "LfD") lap(DirLfD, 1.0, sP, sD);
+            else if (name == "rmD") lap(DirRmD, 1.0, sP, sD);
+            else if (name == "reD") lap(DirReD, 1.0, sP, sD);
+            else if (name == "omega1") lap(DirOmega1, 1.0, sP, sD);
+            else if (name == "omega2") lap(DirOmega2, 1.0, sP, sD);
+            else if (name == "lambda1") lap(DirLambda1, 1.0, sP, sD);
+            else if (name == "cD") lap(DirCD, 1.0, sP, sD);
+            else if (name == "S") lap(DirS, 1.0, sP, sD);
+            result.dP[j][i] = sP;
+            result.dDeriv[j][i] = sD;
+        }
     }
+
+    result.curve = std::make_tuple(tPoints, finalP, finalDP);
+    return result;
 }
 
-// 拉普拉斯空间下的复合模型总函数 (包含井储和表皮)
-double ModelSolver01_06::flaplace_composite(double z, const QMap<QString, double>& p) {
-    double kf = p.value("kf");
-    double km = p.value("km");
-    double LfD = p.value("LfD");
-    double rmD = p.value("rmD");
-    double reD = p.value("reD", 0.0);
-    double omga1 = p.value("omega1");
-    double omga2 = p.value("omega2");
-    double remda1 = p.value("lambda1");
-    int nf = (int)p.value("nf", 4);
-    if(nf < 1) nf = 1;
-
-    double M12 = kf / km;
-
-    // 生成裂缝位置 xwD
-    QVector<double> xwD;
-    if (nf == 1) {
-        xwD.append(0.0);
-    } else {
-        double start = -0.9;
-        double end = 0.9;
-        double step = (end - start) / (nf - 1);
-        for(int i=0; i<nf; ++i) xwD.append(start + i * step);
+// 设置缓存开关
+void ModelSolver01_06::setCurveCacheEnabled(bool enabled)
+{
+    m_options.cacheEnabled = enabled;
+    if (!enabled) clearCurveCache();
+}
+
+// 清空无因次曲线缓存
+void ModelSolver01_06::clearCurveCache() const
+{
+    QMutexLocker locker(&m_cacheMutex);
+    m_curveCache.clear();
+    QMutexLocker reservoirLocker(&m_reservoirMutex);
+    m_reservoirCache.clear();
+}
+
+// 反演阶数: Stehfest 沿用原逻辑 (高精度取参数 N，否则为 4)，设置容差时为自适应的起始阶数 4；
+// 其余算法低精度时取默认阶数的 2/3
+int ModelSolver01_06::resolveInversionOrder(const ModelParams& params, const SolverOptions& options)
+{
+    int order = options.inversionOrder;
+    if (order <= 0) {
+        if (options.inversionMethod == LaplaceInversion::Stehfest && options.inversionTolerance > 0.0) {
+            order = 6;
+        } else if (options.inversionMethod == LaplaceInversion::Stehfest) {
+            int N_param = params.N;
+            order = options.highPrecision ? N_param : 4;
+        } else if (!options.highPrecision) {
+            order = LaplaceInversion::defaultOrder(options.inversionMethod) * 2 / 3;
+        } else {
+            order = LaplaceInversion::defaultOrder(options.inversionMethod);
+        }
     }
+    return order;
+}
 
-    double temp = omga2;
-    double fs1 = omga1 + remda1 * temp / (remda1 + z * temp);
-    double fs2 = M12 * temp;
+// 缓存键: 只包含进入拉普拉斯空间的参数 (kf 以 M12 = kf/km 的形式进入) 及反演设置；
+// 不同调用可带不同选项共用同一缓存
+QVector<double> ModelSolver01_06::dimensionlessKey(const ModelParams& params, const SolverOptions& options) const
+{
+    QVector<double> key;
+    key.reserve(14);
+    key << params.M12
+        << params.LfD
+        << params.rmD
+        << params.omega1
+        << params.omega2
+        << params.lambda1
+        << params.nf;
 
-    // 计算不含井储的拉普拉斯空间压力
-    double pf = PWD_composite(z, fs1, fs2, M12, LfD, rmD, reD, nf, xwD, m_type);
+    if (m_kernel->bounded) {
+        key << params.reD;
+    }
+    if (m_kernel->hasStorage) {
+        key << params.cD << params.S;
+    }
+    // 网格点不取渐近段捷径，渐近段容差不影响网格值，不计入
+    key << double(options.inversionMethod) << double(resolveInversionOrder(params, options))
+        << options.inversionTolerance;
+    return key;
+}
 
-    // 加入井储和表皮效应
-    bool hasStorage = (m_type == Model_1 || m_type == Model_3 || m_type == Model_5);
-    if (hasStorage) {
-        double CD = p.value("cD", 0.0);
-        double S = p.value("S", 0.0);
-        if (CD > 1e-12 || std::abs(S) > 1e-12) {
-            pf = (z * pf + S) / (z + CD * z * z * (z * pf + S));
+// 储层键: 进入 pf(z) 的参数；pf 与反演算法无关，取样点 z 本身即为记忆表的下标
+QVector<double> ModelSolver01_06::reservoirKey(const ModelParams& params) const
+{
+    QVector<double> key;
+    key.reserve(8);
+    key << params.M12
+        << params.LfD
+        << params.rmD
+        << params.omega1
+        << params.omega2
+        << params.lambda1
+        << params.nf;
+    if (m_kernel->bounded) {
+        key << params.reD;
+    }
+    return key;
+}
+
+// 取出记忆表副本 (未命中时新建空表并放到表头)
+ModelSolver01_06::ReservoirEntry ModelSolver01_06::reservoirSnapshot(const QVector<double>& key) const
+{
+    QMutexLocker locker(&m_reservoirMutex);
+    for (int i = 0; i < m_reservoirCache.size(); ++i) {
+        if (m_reservoirCache[i].key == key) {
+            if (i > 0) m_reservoirCache.move(i, 0);
+            return m_reservoirCache.first();
         }
     }
+    ReservoirEntry entry;
+    entry.key = key;
+    m_reservoirCache.prepend(entry);
+    while (m_reservoirCache.size() > maxReservoirEntries()) m_reservoirCache.removeLast();
+    return entry;
+}
 
-    return pf;
+// 并入新取样值 (该组参数已被淘汰时重新加入；超过取样点上限后不再记忆)
+void ModelSolver01_06::storeReservoirSamples(const ReservoirEntry& fresh) const
+{
+    if (fresh.real.isEmpty() && fresh.complex.isEmpty()) return;
+    QMutexLocker locker(&m_reservoirMutex);
+    int found = -1;
+    for (int i = 0; i < m_reservoirCache.size(); ++i) {
+        if (m_reservoirCache[i].key == fresh.key) { found = i; break; }
+    }
+    if (found < 0) {
+        ReservoirEntry entry;
+        entry.key = fresh.key;
+        m_reservoirCache.prepend(entry);
+        while (m_reservoirCache.size() > maxReservoirEntries()) m_reservoirCache.removeLast();
+        found = 0;
+    }
+    ReservoirEntry& entry = m_reservoirCache[found];
+    for (auto it = fresh.real.constBegin(); it != fresh.real.constEnd(); ++it) {
+        if (entry.real.size() + entry.complex.size() >= kMaxReservoirSamples) return;
+        entry.real.insert(it.key(), it.value());
+    }
+    for (auto it = fresh.complex.constBegin(); it != fresh.complex.constEnd(); ++it) {
+        if (entry.real.size() + entry.complex.size() >= kMaxReservoirSamples) return;
+        entry.complex.insert(it.key(), it.value());
+    }
 }
 
-// 核心点源解叠加计算
-double ModelSolver01_06::PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type) {
-    using namespace boost::math;
-    QVector<double> ywD(nf, 0.0); // 假设裂缝在y方向无偏移
-    double gama1 = sqrt(z * fs1);
-    double gama2 = sqrt(z * fs2);
-    double arg_g2_rm = gama2 * rmD;
-    double arg_g1_rm = gama1 * rmD;
-
-    double k0_g2 = cyl_bessel_k(0, arg_g2_rm);
-    double k1_g2 = cyl_bessel_k(1, arg_g2_rm);
-    double k0_g1 = cyl_bessel_k(0, arg_g1_rm);
-    double k1_g1 = cyl_bessel_k(1, arg_g1_rm);
-
-    double term_mAB_i0 = 0.0;
-    double term_mAB_i1 = 0.0;
-
-    bool isInfinite = (type == Model_1 || type == Model_2);
-    bool isClosed = (type == Model_3 || type == Model_4);
-    bool isConstP = (type == Model_5 || type == Model_6);
-
-    // 边界条件处理
-    if (!isInfinite) {
-        double arg_re = gama2 * reD;
-        double i1_re_s = scaled_besseli(1, arg_re);
-        double i0_re_s = scaled_besseli(0, arg_re);
-        double k1_re = cyl_bessel_k(1, arg_re);
-        double k0_re = cyl_bessel_k(0, arg_re);
-        double i0_g2_s = scaled_besseli(0, arg_g2_rm);
-        double i1_g2_s = scaled_besseli(1, arg_g2_rm);
-
-        if (isClosed) {
-            if (i1_re_s > 1e-100) {
-                term_mAB_i0 = (k1_re / i1_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = (k1_re / i1_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+// 通过缓存的主曲线插值 pD 与导数
+// 主曲线 (pD 与解析导数) 制表于 tD = 10^(k/kGridPerDecade)，ln pD 对 ln tD 做三次 Hermite (Catmull-Rom) 插值；
+// 导数同样在双对数坐标下插值。压敏修正在插值之后解析施加: pD' = -ln(1-gamaD*pD)/gamaD，
+// dpD'/dlnt = (dpD/dlnt) / (1-gamaD*pD)，因此 gamaD 的变化也不需要重新反演。
+// 缓存锁只在取出副本与写回时持有，缺失网格点的反演在锁外进行，多个线程可同时计算；
+// 插值使用本次调用的副本，不受其他线程同时写回的影响。
+void ModelSolver01_06::interpolatePDandDeriv(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                                             Report& report, QVector<double>& outPD, QVector<double>& outDeriv) const
+{
+    static const int kGridPerDecade = 20;   // 每个对数周期的网格点数
+    static const int kGridMargin = 2;       // 两端额外网格点，保证插值模板完整
+
+    const int numPoints = tD.size();
+    outPD = QVector<double>(numPoints, 0.0);
+    outDeriv = QVector<double>(numPoints, 0.0);
+
+    // 需要覆盖的网格范围
+    double uMin = 0.0, uMax = 0.0;
+    bool any = false;
+    for (double t : tD) {
+        if (t <= 1e-12) continue;
+        double u = std::log10(t) * kGridPerDecade;
+        if (!any) { uMin = uMax = u; any = true; }
+        uMin = std::min(uMin, u);
+        uMax = std::max(uMax, u);
+    }
+    if (!any) return;
+    const int needLo = (int)std::floor(uMin) - kGridMargin;
+    const int needHi = (int)std::ceil(uMax) + kGridMargin;
+
+    report = Report();
+    report.inversion.method = options.inversionMethod;
+    report.inversion.order = resolveInversionOrder(params, options);
+
+    // 查找 (命中则移到表头) 并取出副本 (隐式共享)
+    const QVector<double> key = dimensionlessKey(params, options);
+    DimensionlessEntry entry;
+    entry.key = key;
+    {
+        QMutexLocker locker(&m_cacheMutex);
+        for (int i = 0; i < m_curveCache.size(); ++i) {
+            if (m_curveCache[i].key == key) {
+                if (i > 0) m_curveCache.move(i, 0);
+                entry = m_curveCache.first();
+                break;
             }
-        } else if (isConstP) {
-            if (i0_re_s > 1e-100) {
-                term_mAB_i0 = -(k0_re / i0_re_s) * i0_g2_s * std::exp(arg_g2_rm - arg_re);
-                term_mAB_i1 = -(k0_re / i0_re_s) * i1_g2_s * std::exp(arg_g2_rm - arg_re);
+        }
+    }
+
+    // 范围不足时只对缺失的网格点反演 (同时得到导数)
+    const bool empty = entry.kHi < entry.kLo;
+    if (empty || needLo < entry.kLo || needHi > entry.kHi) {
+        int newLo = empty ? needLo : std::min(needLo, entry.kLo);
+        int newHi = empty ? needHi : std::max(needHi, entry.kHi);
+
+        QVector<double> missingT;
+        for (int k = newLo; k <= newHi; ++k) {
+            if (empty || k < entry.kLo || k > entry.kHi) {
+                missingT.append(std::pow(10.0, double(k) / kGridPerDecade));
+            }
+        }
+        // 网格点不取渐近段捷径: 渐近段按一批 tD 的范围识别，若用于补算，网格值将取决于此前补算的范围，
+        // 同一参数的结果就与调用历史有关。网格点全部完整反演，只由参数与网格位置决定
+        SolverOptions gridOptions = options;
+        gridOptions.asymptoticTolerance = 0.0;
+        QVector<double> missingDeriv;
+        QVector<double> missingPD = invertPD(missingT, params, gridOptions, report, &missingDeriv);
+
+        QVector<double> gridPD, gridDeriv;
+        gridPD.reserve(newHi - newLo + 1);
+        gridDeriv.reserve(newHi - newLo + 1);
+        int m = 0;
+        for (int k = newLo; k <= newHi; ++k) {
+            if (empty || k < entry.kLo || k > entry.kHi) {
+                gridPD.append(missingPD[m]);
+                gridDeriv.append(missingDeriv[m]);
+                ++m;
+            } else {
+                gridPD.append(entry.pD[k - entry.kLo]);
+                gridDeriv.append(entry.dpD[k - entry.kLo]);
             }
         }
+        entry.kLo = newLo;
+        entry.kHi = newHi;
+        entry.pD = gridPD;
+        entry.dpD = gridDeriv;
+
+        // 写回: 其他线程在此期间已写入更大范围时保留其结果
+        QMutexLocker locker(&m_cacheMutex);
+        int found = -1;
+        for (int i = 0; i < m_curveCache.size(); ++i) {
+            if (m_curveCache[i].key == key) { found = i; break; }
+        }
+        if (found < 0) {
+            m_curveCache.prepend(entry);
+            while (m_curveCache.size() > maxCurveEntries()) m_curveCache.removeLast();
+        } else {
+            if (found > 0) m_curveCache.move(found, 0);
+            DimensionlessEntry& stored = m_curveCache.first();
+            if (stored.kHi - stored.kLo < entry.kHi - entry.kLo) stored = entry;
+        }
+    }
+
+    // 双对数坐标下的 Catmull-Rom 插值，遇到非正值时退化为线性插值
+    auto interp = [&](const QVector<double>& y, double u) -> double {
+        int k = (int)std::floor(u);
+        int i = k - entry.kLo;
+        return ComputeSupport::interpolateLogLog(y[i - 1], y[i], y[i + 1], y[i + 2], u - k);
+    };
+
+    const double gamaD = params.gamaD;
+    for (int k = 0; k < numPoints; ++k) {
+        if (tD[k] <= 1e-12) continue;
+        double u = std::log10(tD[k]) * kGridPerDecade;
+        double pD = interp(entry.pD, u);
+        double dpD = interp(entry.dpD, u);
+
+        // 考虑压敏效应修正
+        if (std::abs(gamaD) > 1e-9) {
+            double arg = 1.0 - gamaD * pD;
+            if (arg > 1e-12) {
+                pD = -1.0 / gamaD * std::log(arg);
+                dpD = dpD / arg;
+            }
+        }
+        outPD[k] = pD;
+        outDeriv[k] = dpD;
+    }
+}
+
+// 数值反演计算 PD 和导数
+void ModelSolver01_06::calculatePDandDeriv(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                                           Report& report, QVector<double>& outPD, QVector<double>& outDeriv) const
+{
+    // 导数 dpD/dln(tD) 与 pD 来自同一组拉普拉斯取样，无需 Bourdet 平滑
+    outPD = invertPD(tD, params, options, report, &outDeriv);
+    applyPressureSensitivity(tD, params.gamaD, outPD, outDeriv);
+}
+
+// 压敏修正 (tD <= 0 的点与 arg <= 0 的点保持原值)
+void ModelSolver01_06::applyPressureSensitivity(const QVector<double>& tD, double gamaD, QVector<double>& pD, QVector<double>& dpD)
+{
+    if (std::abs(gamaD) <= 1e-9) return;
+    for (int k = 0; k < tD.size(); ++k) {
+        if (tD[k] <= 1e-12) continue;
+        double arg = 1.0 - gamaD * pD[k];
+        if (arg > 1e-12) {
+            pD[k] = -1.0 / gamaD * std::log(arg);
+            dpD[k] = dpD[k] / arg;
+        }
     }
+}
 
-    double term1 = term_mAB_i0 + k0_g2;
-    double term2 = term_mAB_i1 - k1_g2;
+// 拉普拉斯反演 (未做压敏修正)
+QVector<double> ModelSolver01_06::invertPD(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                                           Report& report, QVector<double>* outDeriv) const
+{
+    LaplaceInversion inversion(options.inversionMethod, resolveInversionOrder(params, options));
+    inversion.setThreadCount(options.threadCount);
+    inversion.setTolerance(options.inversionTolerance);
+    const double tol = options.asymptoticTolerance;
 
-    double Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+    // pD(0+) 由井储策略给出 (仅有表皮而无井储时为 S，其余为 0)
+    inversion.setInitialValue(m_kernel->initialValue(params));
 
-    double i1_g1_s = scaled_besseli(1, arg_g1_rm);
-    double i0_g1_s = scaled_besseli(0, arg_g1_rm);
+    // 核函数为注册表中按策略组合实例化的静态函数，只读取参数块，可被取样线程同时调用
+    const ModelKernel* kernel = m_kernel;
+    if (!options.cacheEnabled || !kernel->hasStorage) {
+        auto realKernel = [kernel, &params](double z) { return kernel->laplaceReal(z, params); };
+        auto complexKernel = [kernel, &params](const std::complex<double>& z) { return kernel->laplaceComplex(z, params); };
+        return invertWithAsymptotes(inversion, tD, realKernel, complexKernel, tol, report, outDeriv);
+    }
 
-    double Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+    // 带井储模型: pf(z) 先查记忆表 (只读副本)，未命中才计算并暂存，反演结束后一并写回；
+    // 同一组储层参数、同一 tD 网格上只改变 cD、S 时全部命中，核函数只剩井储表皮的代数运算
+    const ReservoirEntry known = reservoirSnapshot(reservoirKey(params));
+    ReservoirEntry fresh;
+    fresh.key = known.key;
+    QMutex freshMutex;
 
-    if (std::abs(Acdown_scaled) < 1e-100) Acdown_scaled = 1e-100;
+    auto realKernel = [&](double z) {
+        double pf;
+        auto it = known.real.constFind(z);
+        if (it != known.real.constEnd()) {
+            pf = it.value();
+        } else {
+            pf = kernel->reservoirReal(z, params);
+            QMutexLocker locker(&freshMutex);
+            fresh.real.insert(z, pf);
+        }
+        return kernel->storageReal(z, pf, params);
+    };
+    auto complexKernel = [&](const std::complex<double>& z) {
+        const QPair<double, double> key(z.real(), z.imag());
+        std::complex<double> pf;
+        auto it = known.complex.constFind(key);
+        if (it != known.complex.constEnd()) {
+            pf = it.value();
+        } else {
+            pf = kernel->reservoirComplex(z, params);
+            QMutexLocker locker(&freshMutex);
+            fresh.complex.insert(key, pf);
+        }
+        return kernel->storageComplex(z, pf, params);
+    };
+    QVector<double> pD = invertWithAsymptotes(inversion, tD, realKernel, complexKernel, tol, report, outDeriv);
+    storeReservoirSamples(fresh);
+    return pD;
+}
 
-    double Ac_prefactor = Acup / Acdown_scaled;
+// 渐近段捷径: 从最早与最晚的时间点向内逐点识别，遇到第一个不满足容差的点即停止 (流动阶段按时间单调推进)。
+// 两段的切换点 (最内侧的渐近点) 与中间各点一起完整反演，用于校验；偏差过大时该段全部改为完整反演
+QVector<double> ModelSolver01_06::invertWithAsymptotes(const LaplaceInversion& inversion, const QVector<double>& tD,
+                                                       const LaplaceInversion::RealKernel& realF,
+                                                       const LaplaceInversion::ComplexKernel& complexF, double tol,
+                                                       Report& report, QVector<double>* outDeriv)
+{
+    report.asymptotic = AsymptoticReport();
+    if (tol <= 0.0 || !realF) {
+        return inversion.invert(tD, realF, complexF, &report.inversion, outDeriv);
+    }
 
-    // 建立线性方程组求解裂缝各段流量分布
-    int size = nf + 1;
-    Eigen::MatrixXd A_mat(size, size);
-    Eigen::VectorXd b_vec(size);
-    b_vec.setZero();
-    b_vec(nf) = 1.0; // 定产条件
-
-    for (int i = 0; i < nf; ++i) {
-        for (int j = 0; j < nf; ++j) {
-            auto integrand = [&](double a) -> double {
-                double dist = std::sqrt(std::pow(xwD[i] - xwD[j] - a, 2) + std::pow(ywD[i] - ywD[j], 2));
-                double arg_dist = gama1 * dist;
-                if (arg_dist < 1e-10) arg_dist = 1e-10;
-
-                double term2 = 0.0;
-                double exponent = arg_dist - arg_g1_rm;
-                if (exponent > -700.0) {
-                    term2 = Ac_prefactor * scaled_besseli(0, arg_dist) * std::exp(exponent);
-                }
-                return cyl_bessel_k(0, arg_dist) + term2;
-            };
-            // 沿裂缝积分
-            double val = adaptiveGauss(integrand, -LfD, LfD, 1e-5, 0, 10);
-            A_mat(i, j) = z * val / (M12 * z * 2 * LfD);
+    // 1. 识别渐近段 (按 tD 升序)
+    QVector<int> order;
+    for (int i = 0; i < tD.size(); ++i) {
+        if (tD[i] > 1e-12) order.append(i);
+    }
+    std::sort(order.begin(), order.end(), [&tD](int a, int b) { return tD[a] < tD[b]; });
+    const int n = order.size();
+
+    AsymptoticScanner scanner(realF, tol);
+    QVector<AsymptoticFit> fits(tD.size());
+    int nEarly = 0;
+    while (nEarly < n && scanner.early(tD[order[nEarly]], fits[order[nEarly]])) ++nEarly;
+    int nLate = 0;
+    while (nEarly + nLate < n && scanner.late(tD[order[n - 1 - nLate]], fits[order[n - 1 - nLate]])) ++nLate;
+
+    // 2. 中间各点与切换点完整反演
+    QVector<int> full;
+    if (nEarly > 0) full.append(order[nEarly - 1]);
+    for (int k = nEarly; k < n - nLate; ++k) full.append(order[k]);
+    if (nLate > 0) full.append(order[n - nLate]);
+    QVector<double> tFull;
+    tFull.reserve(full.size());
+    for (int i : full) tFull.append(tD[i]);
+
+    QVector<double> dFull;
+    LaplaceInversion::Report fullReport;
+    const QVector<double> pFull = inversion.invert(tFull, realF, complexF, &fullReport, outDeriv ? &dFull : nullptr);
+    QVector<double> out(tD.size(), 0.0);
+    if (outDeriv) *outDeriv = QVector<double>(tD.size(), 0.0);
+    // 逐点统计换回输入时间点的下标 (渐近段的点阶数为 0)
+    report.inversion = fullReport;
+    report.inversion.orders = QVector<int>(tD.size(), 0);
+    report.inversion.errors = QVector<double>(tD.size(), 0.0);
+    for (int j = 0; j < full.size(); ++j) {
+        out[full[j]] = pFull[j];
+        if (outDeriv) (*outDeriv)[full[j]] = dFull[j];
+        report.inversion.orders[full[j]] = fullReport.orders[j];
+        report.inversion.errors[full[j]] = fullReport.errors[j];
+    }
+
+    // 3. 切换点校验，通过后其余渐近点解析计算
+    AsymptoticReport& rep = report.asymptotic;
+    rep.kernelCalls = scanner.kernelCalls();
+    QVector<int> rejected;
+    auto apply = [&](int first, int last, int switchIndex, int& points, double& switchTD,
+                     QString& regime, double& mismatch, bool& isRejected) {
+        const AsymptoticFit& fit = fits[switchIndex];
+        switchTD = tD[switchIndex];
+        regime = fit.regime();
+        const double exact = out[switchIndex];
+        mismatch = std::abs(fit.value(switchTD) - exact) / std::max(std::abs(exact), 1e-300);
+        isRejected = !(mismatch <= tol);
+        for (int k = first; k <= last; ++k) {
+            const int i = order[k];
+            if (i == switchIndex) continue;
+            if (isRejected) {
+                rejected.append(i);
+                continue;
+            }
+            out[i] = fits[i].value(tD[i]);
+            if (outDeriv) (*outDeriv)[i] = fits[i].logDerivative(tD[i]);
+            report.inversion.errors[i] = fits[i].error * std::abs(out[i]);
+            ++points;
         }
+    };
+    if (nEarly > 0) {
+        apply(0, nEarly - 1, order[nEarly - 1], rep.earlyPoints, rep.earlySwitchTD,
+              rep.earlyRegime, rep.earlyMismatch, rep.earlyRejected);
     }
-    // 补充方程：各裂缝压力相等，流量和为1
-    for (int i = 0; i < nf; ++i) {
-        A_mat(i, nf) = -1.0;
-        A_mat(nf, i) = z; // 注意这里 z 系数
+    if (nLate > 0) {
+        apply(n - nLate, n - 1, order[n - nLate], rep.latePoints, rep.lateSwitchTD,
+              rep.lateRegime, rep.lateMismatch, rep.lateRejected);
     }
-    A_mat(nf, nf) = 0.0;
 
-    return A_mat.fullPivLu().solve(b_vec)(nf);
+    // 4. 未通过校验的点补做完整反演
+    if (!rejected.isEmpty()) {
+        QVector<double> tRejected, dRejected;
+        for (int i : rejected) tRejected.append(tD[i]);
+        LaplaceInversion::Report extra;
+        const QVector<double> pRejected = inversion.invert(tRejected, realF, complexF, &extra, outDeriv ? &dRejected : nullptr);
+        for (int j = 0; j < rejected.size(); ++j) {
+            out[rejected[j]] = pRejected[j];
+            if (outDeriv) (*outDeriv)[rejected[j]] = dRejected[j];
+            report.inversion.orders[rejected[j]] = extra.orders[j];
+            report.inversion.errors[rejected[j]] = extra.errors[j];
+        }
+        report.inversion.order = std::max(report.inversion.order, extra.order);
+        report.inversion.kernelCalls += extra.kernelCalls;
+        report.inversion.timePoints += extra.timePoints;
+        report.inversion.windows += extra.windows;
+        report.inversion.maxEstimatedError = std::max(report.inversion.maxEstimatedError, extra.maxEstimatedError);
+    }
+    report.inversion.kernelCalls += rep.kernelCalls;
+    report.inversion.timePoints += rep.earlyPoints + rep.latePoints;
+    return out;
 }
 
-// 缩放的贝塞尔 I 函数 I(x)*exp(-x)，防止溢出
-double ModelSolver01_06::scaled_besseli(int v, double x) {
-    if (x < 0) x = -x;
-    if (x > 600.0) return 1.0 / std::sqrt(2.0 * M_PI * x);
-    return boost::math::cyl_bessel_i(v, x) * std::exp(-x);
+// 拉普拉斯空间下的复合模型总函数 (包含井储和表皮)
+template<typename Model, typename T, typename Params>
+T ModelSolver01_06::flaplace_composite(const T& z, const Params& p) {
+    return storage_composite<Model>(z, reservoir_composite<Model, T>(z, p), p);
 }
 
-// 高斯积分点
-double ModelSolver01_06::gauss15(std::function<double(double)> f, double a, double b) {
-    static const double X[] = { 0.0, 0.201194, 0.394151, 0.570972, 0.724418, 0.848207, 0.937299, 0.987993 };
-    static const double W[] = { 0.202578, 0.198431, 0.186161, 0.166269, 0.139571, 0.107159, 0.070366, 0.030753 };
-    double h = 0.5 * (b - a); double c = 0.5 * (a + b); double s = W[0] * f(c);
-    for (int i = 1; i < 8; ++i) { double dx = h * X[i]; s += W[i] * (f(c - dx) + f(c + dx)); }
-    return s * h;
+// 不含井储的拉普拉斯空间压力
+template<typename Model, typename T, typename Params>
+T ModelSolver01_06::reservoir_composite(const T& z, const Params& p) {
+    const auto& M12 = p.M12;
+
+    const auto& temp = p.omega2;
+    T fs1 = p.omega1 + p.lambda1 * temp / (p.lambda1 + z * temp);
+    T fs2 = T(M12 * temp);
+
+    return PWD_composite<typename Model::Boundary>(z, fs1, fs2, M12, p.LfD, p.rmD, p.reD, p.nf, p.xwD);
 }
 
-// 自适应高斯积分
-double ModelSolver01_06::adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth) {
-    double c = (a + b) / 2.0; double v1 = gauss15(f, a, b); double v2 = gauss15(f, a, c) + gauss15(f, c, b);
-    if (depth >= maxDepth || std::abs(v1 - v2) < 1e-10 * std::abs(v2) + eps) return v2;
-    return adaptiveGauss(f, a, c, eps/2, depth+1, maxDepth) + adaptiveGauss(f, c, b, eps/2, depth+1, maxDepth);
+// 加入井储和表皮效应
+template<typename Model, typename T, typename Params>
+T ModelSolver01_06::storage_composite(const T& z, const T& pf, const Params& p) {
+    return Model::Storage::apply(z, pf, p);
 }
 
-// Stehfest 系数
-double ModelSolver01_06::stefestCoefficient(int i, int N) {
-    double s = 0.0; int k1 = (i + 1) / 2; int k2 = std::min(i, N / 2);
-    for (int k = k1; k <= k2; ++k) {
-        double num = pow(k, N / 2.0) * factorial(2 * k);
-        double den = factorial(N / 2 - k) * factorial(k) * factorial(k - 1) * factorial(i - k) * factorial(2 * k - i);
-        if(den!=0) s += num/den;
+// 核心点源解叠加计算
+template<typename Boundary, typename T, typename P>
+T ModelSolver01_06::PWD_composite(const T& z, const T& fs1, const T& fs2, const P& M12, const P& LfD, const P& rmD, const P& reD, int nf, const QVector<double>& xwD) {
+    using BF = BesselFunctions;
+    using std::sqrt;
+    using std::exp;
+    using std::abs;
+    using std::real;
+    T gama1 = sqrt(z * fs1);
+    T gama2 = sqrt(z * fs2);
+    T arg_g2_rm = gama2 * rmD;
+    T arg_g1_rm = gama1 * rmD;
+
+    T k0_g2, k1_g2, i0_g2_s, i1_g2_s;
+    T k0_g1, k1_g1, i0_g1_s, i1_g1_s;
+    besselEvaluate(arg_g2_rm, &k0_g2, &k1_g2, &i0_g2_s, &i1_g2_s);
+    besselEvaluate(arg_g1_rm, &k0_g1, &k1_g1, &i0_g1_s, &i1_g1_s);
+
+    // 边界条件处理 (编译期选定)
+    T term_mAB_i0, term_mAB_i1;
+    Boundary::outerTerms(gama2, reD, arg_g2_rm, i0_g2_s, i1_g2_s, term_mAB_i0, term_mAB_i1);
+
+    T term1 = term_mAB_i0 + k0_g2;
+    T term2 = term_mAB_i1 - k1_g2;
+
+    T Acup = M12 * gama1 * k1_g1 * term1 + gama2 * k0_g1 * term2;
+
+    T Acdown_scaled = M12 * gama1 * i1_g1_s * term1 - gama2 * i0_g1_s * term2;
+
+    if (abs(Acdown_scaled) < 1e-100) Acdown_scaled = T(1e-100);
+
+    T Ac_prefactor = Acup / Acdown_scaled;
+
+    // 裂缝 j 对裂缝 i 的影响系数，只与间距 d = xwD[i] - xwD[j] 有关，且 I(d) = I(-d)
+    // (裂缝在 y 方向无偏移，点间距离只取决于 x 方向)
+    // 沿裂缝积分 g(r) = K0(gama1*r) + Ac*I0(gama1*r)*exp(-gama1*rm)，r = |d - a|，a 属于 [-LfD, LfD]；
+    // 按距离 r 划分定节点面板，含 r = 0 的面板扣除对数奇异项后积分，再补回其解析积分
+    const double gamaAbs = abs(gama1);
+    const double lfd = valueOf(LfD);   // 面板划分只取 LfD 的值 (对偶数的 LfD 偏导见端点项)
+    const T gama1Sq4 = gama1 * gama1 / 4.0;
+    const GaussLegendreTable& gl = gaussLegendre();
+    PWDWorkspace<T>& ws = pwdWorkspace<T>();
+    auto influence = [&](double d) -> T {
+        QVector<QuadPanel>& panels = ws.panels;
+        panels.clear();
+        if (d > -lfd && d < lfd) {
+            appendPanels(0.0, d + lfd, gamaAbs, panels);
+            appendPanels(0.0, lfd - d, gamaAbs, panels);
+        } else {
+            appendPanels(std::abs(d) - lfd, std::abs(d) + lfd, gamaAbs, panels);
+        }
+
+        // 所有面板的节点一次批量计算贝塞尔函数
+        const int total = panels.size() * kQuadOrder;
+        QVector<double>& r = ws.r;
+        QVector<T>& arg = ws.arg;
+        QVector<T>& k0v = ws.k0v;
+        QVector<T>& i0v = ws.i0v;
+        r.resize(total);
+        arg.resize(total);
+        k0v.resize(total);
+        i0v.resize(total);
+        for (int p = 0; p < panels.size(); ++p) {
+            double h = 0.5 * (panels[p].hi - panels[p].lo);
+            double c = 0.5 * (panels[p].hi + panels[p].lo);
+            for (int k = 0; k < kQuadOrder; ++k) {
+                r[p * kQuadOrder + k] = c + h * gl.x[k];
+                arg[p * kQuadOrder + k] = gama1 * r[p * kQuadOrder + k];
+            }
+        }
+        besselEvaluate(arg.constData(), total, k0v.data(), (T*)nullptr, i0v.data(), (T*)nullptr);
+
+        T val = T(0.0);
+        for (int p = 0; p < panels.size(); ++p) {
+            const QuadPanel& panel = panels[p];
+            double h = 0.5 * (panel.hi - panel.lo);
+            T sum = T(0.0);
+            for (int k = 0; k < kQuadOrder; ++k) {
+                const int n = p * kQuadOrder + k;
+                T g = k0v[n];
+                T exponent = arg[n] - arg_g1_rm;
+                if (real(exponent) > -700.0) {
+                    g += Ac_prefactor * i0v[n] * exp(exponent);
+                }
+                // 奇异面板: K0(x) = -ln(r)*(1 + x^2/4) + O(r^4*ln r) + 光滑项，扣除前两项
+                if (panel.singular) {
+                    g += std::log(r[n]) * (1.0 + gama1Sq4 * (r[n] * r[n]));
+                }
+                sum += gl.w[k] * g;
+            }
+            val += sum * h;
+            if (panel.singular) {
+                // 补回 -int_0^L ln(r)*(1 + gama1^2*r^2/4) dr
+                double L = panel.hi;
+                double lnL = std::log(L);
+                val -= L * (lnL - 1.0) + gama1Sq4 * (L * L * L * (lnL / 3.0 - 1.0 / 9.0));
+            }
+        }
+
+        // 对偶数的 LfD 方向: 积分限 a = ±LfD 随 LfD 移动 (节点按 LfD 的值固定)，
+        // 由 Leibniz 公式补充端点项 d/dLfD = g(|d - LfD|) + g(|d + LfD|)
+        if constexpr (IsDual<P>::value) {
+            using S = typename ValueType<T>::type;
+            S ends = S(0.0);
+            for (double rEnd : { std::abs(d - lfd), std::abs(d + lfd) }) {
+                if (rEnd <= 1e-12) continue;
+                S x = gama1.v * rEnd;
+                S k0e, i0e;
+                BF::evaluate(x, &k0e, nullptr, &i0e, nullptr);
+                S ex = x - arg_g1_rm.v;
+                if (std::real(ex) > -700.0) k0e += Ac_prefactor.v * i0e * std::exp(ex);
+                ends += k0e;
+            }
+            val += T::chain(S(0.0), ends, LfD);
+        }
+        return z * val / (M12 * z * 2.0 * LfD);
+    };
+
+    // 方程组: sum_j A(i,j)*q_j - pw = 0 (各裂缝压力相等)，z*sum_j q_j = 1 (定产条件)
+    // 消去 pw 后: A*y = 1，pw = 1 / (z*sum(y))
+
+    // 1. 裂缝等间距时 A 为对称 Toeplitz 矩阵: 只积分 nf 个间距，Levinson 递推求解 O(nf^2)
+    bool uniform = true;
+    for (int i = 2; i < nf; ++i) {
+        if (std::abs((xwD[i] - xwD[i - 1]) - (xwD[1] - xwD[0])) > 1e-12) { uniform = false; break; }
+    }
+    if (uniform) {
+        ws.col.resize(nf);
+        ws.ones.fill(T(1.0), nf);
+        for (int k = 0; k < nf; ++k) ws.col[k] = influence(xwD[k] - xwD[0]);
+        if (solveSymmetricToeplitz(ws.col, ws.ones, ws.y, ws.f, ws.fNew)) {
+            T sumY = T(0.0);
+            for (int k = 0; k < nf; ++k) sumY += ws.y[k];
+            return T(1.0) / (z * sumY);
+        }
+    }
+
+    // 2. 一般情况 (或 Levinson 递推主子式奇异): 利用对称性积分上三角，完整 LU 求解
+    // 右端项为 e_nf (定产条件)
+    int size = nf + 1;
+    auto assemble = [&](auto&& set) {
+        for (int i = 0; i < nf; ++i) {
+            for (int j = i; j < nf; ++j) {
+                T a = influence(xwD[i] - xwD[j]);
+                set(i, j, a);
+                set(j, i, a);
+            }
+        }
+        // 补充方程：各裂缝压力相等，流量和为1
+        for (int i = 0; i < nf; ++i) {
+            set(i, nf, T(-1.0));
+            set(nf, i, z); // 注意这里 z 系数
+        }
+        set(nf, nf, T(0.0));
+    };
+
+    if constexpr (IsDual<T>::value) {
+        // 对偶数: 只对系数矩阵的值做 LU 分解，各方向的偏导由 x' = -A^-1 * A' * x 求得 (右端项为常数)
+        using S = typename ValueType<T>::type;
+        QVector<T>& sys = ws.system;
+        sys.resize(size * size);
+        assemble([&](int i, int j, const T& v) { sys[i * size + j] = v; });
+
+        int dirs = 0;
+        ws.A.resize(size, size);
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                ws.A(i, j) = sys[i * size + j].v;
+                dirs = std::max(dirs, sys[i * size + j].n);
+            }
+        }
+        ws.b.setZero(size);
+        ws.b(nf) = S(1.0);
+        ws.lu.compute(ws.A);
+        ws.x = ws.lu.solve(ws.b);
+
+        T result(ws.x(nf));
+        result.n = dirs;
+        ws.rhs.resize(size);
+        for (int k = 0; k < dirs; ++k) {
+            for (int i = 0; i < size; ++i) {
+                S acc = S(0.0);
+                for (int j = 0; j < size; ++j) acc -= sys[i * size + j].derivative(k) * ws.x(j);
+                ws.rhs(i) = acc;
+            }
+            result.d[k] = ws.lu.solve(ws.rhs)(nf);
+        }
+        return result;
+    } else {
+        // 小规模方程组: 定长上限矩阵在栈上分配，LU 分解同样不申请堆内存
+        if (size <= kFixedSystemMax) {
+            Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, 0, kFixedSystemMax, kFixedSystemMax> A_mat(size, size);
+            Eigen::Matrix<T, Eigen::Dynamic, 1, 0, kFixedSystemMax, 1> b_vec(size);
+            assemble([&](int i, int j, const T& v) { A_mat(i, j) = v; });
+            b_vec.setZero();
+            b_vec(nf) = T(1.0);
+            return A_mat.fullPivLu().solve(b_vec)(nf);
+        }
+
+        // 较大方程组: 复用工作区中的矩阵与分解对象 (阶数不变时不重新分配)
+        ws.A.resize(size, size);
+        assemble([&](int i, int j, const T& v) { ws.A(i, j) = v; });
+        ws.b.setZero(size);
+        ws.b(nf) = T(1.0);
+        ws.lu.compute(ws.A);
+        return ws.lu.solve(ws.b)(nf);
     }
-    return ((i + N / 2) % 2 == 0 ? 1.0 : -1.0) * s;
 }
 
-// 阶乘
-double ModelSolver01_06::factorial(int n) {
-    if(n<=1)return 1;
-    double r=1;
-    for(int i=2;i<=n;++i) r*=i;
-    return r;
+// 对称 Toeplitz 方程组 T*x = b 的 Levinson 递推 (r 为首列，复数情形为复对称而非 Hermite)
+// 前向向量 f 满足 T_n*f = e_1，由对称性后向向量为 f 的逆序；主子式奇异时返回 false
+// f、fNew 为调用方提供的递推向量 (复用其容量)
+template<typename T>
+bool ModelSolver01_06::solveSymmetricToeplitz(const QVector<T>& r, const QVector<T>& b, QVector<T>& x,
+                                              QVector<T>& f, QVector<T>& fNew)
+{
+    using std::abs;
+    const int n = r.size();
+    if (n == 0 || abs(r[0]) < 1e-300) return false;
+
+    f.resize(n);
+    fNew.resize(n);
+    x.resize(n);
+    f[0] = T(1.0) / r[0];
+    x[0] = b[0] / r[0];
+
+    for (int m = 1; m < n; ++m) {
+        // [f;0] 与 [x;0] 在第 m 行的残量
+        T ef = T(0.0), ex = T(0.0);
+        for (int i = 0; i < m; ++i) {
+            ef += r[m - i] * f[i];
+            ex += r[m - i] * x[i];
+        }
+        T denom = T(1.0) - ef * ef;
+        if (abs(denom) < 1e-14) return false;
+
+        // f_new = ([f;0] - ef*[0;rev(f)]) / (1 - ef^2)
+        for (int i = 0; i <= m; ++i) {
+            T fi = (i < m) ? f[i] : T(0.0);
+            T bi = (i > 0) ? f[m - i] : T(0.0);
+            fNew[i] = (fi - ef * bi) / denom;
+        }
+        for (int i = 0; i <= m; ++i) f[i] = fNew[i];
+
+        // x_new = [x;0] + (b_m - ex) * rev(f_new)
+        x[m] = T(0.0);
+        T coef = b[m] - ex;
+        for (int i = 0; i <= m; ++i) x[i] += coef * f[m - i];
+    }
+    return true;
 }
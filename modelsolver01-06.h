@@ -3,8 +3,29 @@
  * 文件作用: 压裂水平井复合页岩油模型核心计算类头文件
  * 功能描述:
  * 1. 定义模型类型枚举 (ModelType) 和曲线数据类型 (ModelCurveData)。
- * 2. 声明纯数学计算逻辑，包括拉普拉斯变换、贝塞尔函数计算、Stehfest 数值反演等。
- * 3. 不依赖任何 UI 控件，仅负责数据输入与结果输出。
+ * 2. 声明纯数学计算逻辑，包括拉普拉斯变换、贝塞尔函数计算、数值反演等。
+ * 3. 拉普拉斯空间函数按标量类型模板化 (实数/复数)，可切换 Stehfest、Talbot、de Hoog、Euler 反演后端。
+ * 4. 无因次曲线 pD(tD) 与物理量换算分层：无因次曲线按拉普拉斯空间参数缓存，
+ *    q、mu、B、h、phi、Ct、L 等仅做压力/时间缩放的参数变化时不再重新反演。
+ * 5. 参数表在每条曲线计算开始时解析为 ModelParams 参数块，拉普拉斯空间计算不再做字符串查找。
+ * 6. 模型族由边界条件策略 × 井储策略在编译期组合生成，每个模型的拉普拉斯空间核函数不含模型类型分支；
+ *    模型注册表 (ModelKernel) 记录各模型的核函数与特征，新增模型只需增加一个策略组合和一行注册。
+ * 7. 拉普拉斯空间核函数同时按参数标量类型模板化：以对偶数 (dualnumber.h) 实例化时一次计算得到曲线
+ *    及其对各参数的偏导数 (前向自动微分)，供拟合时构造精确的 Jacobian。
+ * 8. 储层核函数记忆化: 井储 cD 与表皮 S 只在储层解 pf(z) 上做代数修正，按储层参数记忆各取样点的 pf(z)，
+ *    只改变 cD、S 的试算 (早期段拟合) 不再重复计算裂缝积分与线性方程组。
+ * 9. 渐近段捷径: 在 z ~ 1/tD 附近拉普拉斯空间函数与早期幂律 (井储单位斜率、线性流、双线性流) 或
+ *    晚期形式 (径向流、拟稳态、稳态) 的偏差小于容差时，该时间点直接用渐近解析式计算，
+ *    切换点同时做完整反演校验 (相对偏差不超过容差) 并记录在 AsymptoticReport 中。渐近段按一次调用的 tD 范围识别，
+ *    只用于不经缓存的直接计算；无因次主曲线的网格点总是完整反演，缓存结果与调用历史无关。
+ * 10. Stehfest 可按误差容差逐时间点自适应选取阶数，各点阶数与估计误差见 lastInversionReport()。
+ * 11. 预览曲线: 设置类型曲线库 (typecurvelibrary.h) 后，储层解 pf(z) 从库中插值，只做井储表皮代数与低阶 Stehfest 反演；
+ *     参数超出库的范围时自动回退到精确计算。
+ * 12. 可重入接口: 精度、反演算法、容差等设置打包为 SolverOptions 随每次调用传入，统计信息由调用方取回；
+ *     求解器对象构造后不再改变 (内部缓存自带互斥锁)，多个拟合线程与界面可同时使用同一个求解器。
+ *     保留的设置函数 (setHighPrecision 等) 只修改旧接口使用的默认选项，供单一线程的界面使用。
+ * 13. 变产量曲线: 在对数网格上计算单位产量响应，再按产量历史快速叠加 (ratesuperposition.h)。
+ * 14. 不依赖任何 UI 控件，仅负责数据输入与结果输出。
  */
 
 #ifndef MODELSOLVER01_06_H  // 修改点：将 - 改为 _
@@ -13,12 +34,101 @@
 #include <QMap>
 #include <QVector>
 #include <QString>
+#include <QList>
+#include <QStringList>
+#include <QMutex>
+#include <QHash>
+#include <QPair>
 #include <tuple>
-#include <functional>
+#include <complex>
+#include "laplaceinversion.h"
+#include "dualnumber.h"
+
+class TypeCurveLibrary;
+class RateSuperposition;
 
 // 类型定义: <时间, 压力, 导数>
 using ModelCurveData = std::tuple<QVector<double>, QVector<double>, QVector<double>>;
 
+// 模型参数块: 由参数表解析一次，计算过程中直接读取成员
+// 缺省值与 ModelManager::getDefaultParameters 一致 (gamaD、cD、S、reD 缺省为 0)
+struct ModelParams
+{
+    // 物理参数 (仅参与 tD 与压差的换算)
+    double phi = 0.05;
+    double mu = 0.5;
+    double B = 1.05;
+    double Ct = 5e-4;
+    double q = 5.0;
+    double h = 20.0;
+    double L = 1000.0;
+
+    // 渗透率 (kf 同时参与换算与导流比 M12)
+    double kf = 1e-3;
+    double km = 1e-4;
+
+    // 无因次参数
+    double LfD = 0.1;
+    double rmD = 4.0;
+    double reD = 0.0;
+    double omega1 = 0.4;
+    double omega2 = 0.08;
+    double lambda1 = 1e-3;
+    int nf = 4;
+    double cD = 0.0;
+    double S = 0.0;
+    double gamaD = 0.0;
+
+    // Stehfest 阶数 (高精度模式使用)
+    int N = 4;
+
+    // 派生量 (由 updateDerived 计算)
+    double M12 = 10.0;          // kf / km
+    QVector<double> xwD;        // 裂缝位置
+
+    // 从参数表解析 (nf 至少为 1)，并计算派生量
+    static ModelParams fromMap(const QMap<QString, double>& p);
+    // 修改成员后重新计算派生量
+    void updateDerived();
+    // 检查参数是否在物理范围内 (bounded 为封闭/定压边界模型)；精确计算照常进行，只有类型曲线库预览据此回退
+    bool isValid(bool bounded, QString* error = nullptr) const;
+};
+
+// 灵敏度计算用的参数块: 进入拉普拉斯空间的参数取对偶数类型 P (字段名与 ModelParams 一致)，
+// 与 ModelParams 共用同一份核函数模板
+template<typename P>
+struct SensitivityParams
+{
+    P M12, LfD, rmD, reD, omega1, omega2, lambda1, cD, S;
+    int nf = 1;
+    QVector<double> xwD;
+};
+
+// 求解器选项: 可重入接口的每次调用都带一份，求解器不保存 (默认值与旧接口的初始设置一致)
+struct SolverOptions
+{
+    bool highPrecision = true;                                      // 高精度 (Stehfest 取参数 N 阶)
+    LaplaceInversion::Method inversionMethod = LaplaceInversion::Stehfest;
+    int inversionOrder = 0;                                         // 0 为按精度模式选取默认阶数
+    int threadCount = 0;                                            // 反演取样线程数 (0 为自动，1 为串行)，不影响结果
+    double inversionTolerance = 0.0;                                // Stehfest 自适应选阶容差 (0 为固定阶数)
+    double asymptoticTolerance = 1e-4;                              // 渐近段捷径容差 (0 为关闭；只用于不经缓存的计算)
+    bool cacheEnabled = true;                                       // 使用无因次曲线缓存与储层核函数记忆表
+    const TypeCurveLibrary* typeCurveLibrary = nullptr;             // 预览曲线用的类型曲线库 (不拥有)
+
+    // 影响计算结果的选项组成的键 (不含线程数与类型曲线库)，供外部结果缓存区分设置
+    QVector<double> key() const;
+};
+
+// 曲线及其对参数的偏导数: dP[j][i] = d(压差)/d(names[j]) 于 t[i]，dDeriv 为导数曲线的偏导
+struct CurveSensitivity
+{
+    ModelCurveData curve;
+    QStringList names;
+    QVector<QVector<double>> dP;
+    QVector<QVector<double>> dDeriv;
+};
+
 class ModelSolver01_06
 {
 public:
@@ -32,44 +142,256 @@ public:
         Model_6      // 定压边界 + 恒定井储
     };
 
+    // 外边界类型 (类型曲线库按外边界分块)
+    enum BoundaryType {
+        Infinite = 0,
+        Closed,
+        ConstantPressure
+    };
+
+    using RealDual = Dual<double>;
+    using ComplexDual = Dual<std::complex<double>>;
+
+    // 模型注册表项: 由边界策略与井储策略组合编译生成的核函数及模型特征
+    struct ModelKernel {
+        ModelType type;
+        const char* name;
+        BoundaryType boundary;
+        bool bounded;       // 封闭/定压边界 (需要参数 reD)
+        bool hasStorage;    // 考虑井储与表皮 (需要参数 cD、S)
+        double (*laplaceReal)(const double& z, const ModelParams& p);
+        std::complex<double> (*laplaceComplex)(const std::complex<double>& z, const ModelParams& p);
+        double (*initialValue)(const ModelParams& p);   // pD(0+)，用于解析导数
+        // 拆分的核函数: 储层解 pf(z) (与 cD、S 无关) 与井储表皮修正 (由 pf 做代数运算)，二者复合即 laplace*
+        double (*reservoirReal)(const double& z, const ModelParams& p);
+        std::complex<double> (*reservoirComplex)(const std::complex<double>& z, const ModelParams& p);
+        double (*storageReal)(const double& z, const double& pf, const ModelParams& p);
+        std::complex<double> (*storageComplex)(const std::complex<double>& z, const std::complex<double>& pf, const ModelParams& p);
+        // 对偶数版本 (灵敏度计算)
+        RealDual (*laplaceRealDual)(const RealDual& z, const SensitivityParams<RealDual>& p);
+        ComplexDual (*laplaceComplexDual)(const ComplexDual& z, const SensitivityParams<ComplexDual>& p);
+        RealDual (*initialValueDual)(const SensitivityParams<RealDual>& p);
+    };
+
+    // 渐近段统计: 早期/晚期直接按渐近解析式计算的点数、切换点及切换点处与完整反演的相对偏差
+    struct AsymptoticReport {
+        int earlyPoints = 0;
+        int latePoints = 0;
+        double earlySwitchTD = 0.0;     // 早期渐近段的最后一个 tD
+        double lateSwitchTD = 0.0;      // 晚期渐近段的第一个 tD
+        QString earlyRegime;
+        QString lateRegime;
+        double earlyMismatch = 0.0;
+        double lateMismatch = 0.0;
+        bool earlyRejected = false;     // 校验偏差过大，该段改为完整反演
+        bool lateRejected = false;
+        int kernelCalls = 0;            // 识别渐近段所用的核函数调用次数
+    };
+
+    // 单次计算的统计: 反演统计 (核函数调用次数、估计误差；orders/errors 与该次反演的时间点一一对应，
+    // 缓存模式下为新增的主曲线网格点，渐近段的点阶数为 0) 与渐近段统计
+    struct Report {
+        LaplaceInversion::Report inversion;
+        AsymptoticReport asymptotic;
+    };
+
     // 构造函数
     explicit ModelSolver01_06(ModelType type);
     virtual ~ModelSolver01_06();
 
+    // ---- 可重入接口: 设置随 options 传入，统计写入 report (可为空)，可在多个线程同时调用 ----
+
+    // 核心计算接口：根据参数和时间序列计算理论曲线 (时间序列为空时取 10^-3 ~ 10^3 的 100 个点)
+    ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                             const SolverOptions& options, Report* report = nullptr) const;
+    ModelCurveData calculateTheoreticalCurve(const ModelParams& params, const QVector<double>& providedTime,
+                                             const SolverOptions& options, Report* report = nullptr) const;
+
+    // 预览曲线: options 带有类型曲线库且参数在库的范围内时由库插值得到 pf(z)，否则等同 calculateTheoreticalCurve；
+    // 精度低于精确计算 (见库的校验误差)，用于交互拖动与自动初值的参考曲线等只需近似的场合，拟合残差与 Jacobian 不使用
+    ModelCurveData calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime,
+                                         const SolverOptions& options) const;
+    ModelCurveData calculatePreviewCurve(const ModelParams& params, const QVector<double>& providedTime,
+                                         const SolverOptions& options) const;
+
+    // 无因次曲线接口：直接在给定 tD 上反演，返回 <tD, pD, dpD> (不经过缓存)
+    ModelCurveData calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD,
+                                               const SolverOptions& options, Report* report = nullptr) const;
+    ModelCurveData calculateDimensionlessCurve(const ModelParams& params, const QVector<double>& tD,
+                                               const SolverOptions& options, Report* report = nullptr) const;
+
+    // 参数灵敏度: 一次多通道反演同时得到曲线及其对 names 中各参数的偏导数 (前向自动微分，不经过缓存)
+    // 可求导的参数: phi mu B Ct q h L kf km LfD rmD reD omega1 omega2 lambda1 cD S gamaD；
+    // nf、N 及求解器不读取的参数偏导为 0
+    CurveSensitivity calculateSensitivities(const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names,
+                                            const SolverOptions& options, Report* report = nullptr) const;
+    CurveSensitivity calculateSensitivities(const ModelParams& params, const QVector<double>& t, const QStringList& names,
+                                            const SolverOptions& options, Report* report = nullptr) const;
+
+    // 变产量曲线: 按 history 的产量历史叠加，返回 <t, 压差, t*d(压差)/dt>；参数 q 不参与 (产量取自 history)，
+    // 单位产量响应只在 t 所需的 tau 范围内计算一次 (report 为该次计算的统计)
+    ModelCurveData calculateVariableRateCurve(const QMap<QString, double>& params, const QVector<double>& t,
+                                              const RateSuperposition& history, const SolverOptions& options,
+                                              Report* report = nullptr) const;
+    ModelCurveData calculateVariableRateCurve(const ModelParams& params, const QVector<double>& t,
+                                              const RateSuperposition& history, const SolverOptions& options,
+                                              Report* report = nullptr) const;
+
+    // ---- 旧接口: 使用求解器保存的默认选项，最近一次统计保存在求解器中；设置函数与计算不可并发调用 ----
+
     // 设置计算精度
     void setHighPrecision(bool high);
 
-    // 核心计算接口：根据参数和时间序列计算理论曲线
+    // 设置拉普拉斯反演算法 (order 为 0 时按精度模式选取默认阶数)
+    void setInversionMethod(LaplaceInversion::Method method, int order = 0);
+    LaplaceInversion::Method inversionMethod() const { return m_options.inversionMethod; }
+
+    // 反演取样线程数 (0 为自动，1 为串行)，结果与线程数无关
+    void setThreadCount(int count);
+    int threadCount() const { return m_options.threadCount; }
+
+    // Stehfest 误差容差 (> 0 时从 4 阶起逐点自适应选阶，不再区分高/低精度；0 为固定阶数，默认)
+    void setInversionTolerance(double tol);
+    double inversionTolerance() const { return m_options.inversionTolerance; }
+
+    // 最近一次曲线计算的反演统计
+    LaplaceInversion::Report lastInversionReport() const;
+
+    // 渐近段捷径的拉普拉斯空间相对容差 (0 表示关闭，默认 1e-4)；最近一次反演的渐近段统计
+    void setAsymptoticTolerance(double tol);
+    double asymptoticTolerance() const { return m_options.asymptoticTolerance; }
+    AsymptoticReport lastAsymptoticReport() const;
+
+    // 类型曲线库 (不转移所有权，库须在求解器使用期间保持打开；nullptr 为不使用)
+    void setTypeCurveLibrary(const TypeCurveLibrary* library);
+    const TypeCurveLibrary* typeCurveLibrary() const { return m_options.typeCurveLibrary; }
+
+    // 无因次曲线缓存与储层核函数记忆表开关 (默认开启)
+    void setCurveCacheEnabled(bool enabled);
+
+    // 旧接口使用的默认选项
+    const SolverOptions& options() const { return m_options; }
+
     ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculateTheoreticalCurve(const ModelParams& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculatePreviewCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculatePreviewCurve(const ModelParams& params, const QVector<double>& providedTime = QVector<double>());
+    ModelCurveData calculateDimensionlessCurve(const QMap<QString, double>& params, const QVector<double>& tD);
+    ModelCurveData calculateDimensionlessCurve(const ModelParams& params, const QVector<double>& tD);
+    CurveSensitivity calculateSensitivities(const QMap<QString, double>& params, const QVector<double>& t, const QStringList& names);
+    CurveSensitivity calculateSensitivities(const ModelParams& params, const QVector<double>& t, const QStringList& names);
+
+    // 清空无因次曲线缓存与储层核函数记忆表 (可与计算并发调用)
+    void clearCurveCache() const;
 
     // 获取模型名称（静态辅助函数）
     static QString getModelName(ModelType type);
 
+    // 模型注册表: 按注册顺序返回全部模型类型；查询某一模型的核函数与特征 (未注册的类型返回模型1)
+    static QVector<ModelType> registeredModels();
+    static const ModelKernel& modelKernel(ModelType type);
+
     // 生成对数时间步长（静态辅助函数，供内部或外部生成时间序列使用）
     static QVector<double> generateLogTimeSteps(int count, double startExp, double endExp);
 
 private:
+    // 缓存的无因次主曲线: 在 tD = 10^(k/kGridPerDecade), k = kLo..kHi 的对数等距网格上制表
+    struct DimensionlessEntry {
+        QVector<double> key;    // 进入拉普拉斯空间的参数及反演设置
+        int kLo = 0;
+        int kHi = -1;
+        QVector<double> pD;
+        QVector<double> dpD;
+    };
+
+    // 储层核函数记忆表: 同一组储层参数下已计算的 pf(z)，按取样点 z 查找
+    struct ReservoirEntry {
+        QVector<double> key;    // 储层参数 (不含 cD、S 及反演设置)
+        QHash<double, double> real;
+        QHash<QPair<double, double>, std::complex<double>> complex;
+    };
+
+    // 提取影响储层解 pf(z) 的参数
+    QVector<double> reservoirKey(const ModelParams& params) const;
+    // 取出某组储层参数的记忆表副本 (隐式共享，取样线程可同时只读访问)
+    ReservoirEntry reservoirSnapshot(const QVector<double>& key) const;
+    // 将本次反演新算出的 pf(z) 并入记忆表
+    void storeReservoirSamples(const ReservoirEntry& fresh) const;
+
+    // 通过缓存的主曲线插值得到给定 tD 上的 pD 与导数
+    void interpolatePDandDeriv(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                               Report& report, QVector<double>& outPD, QVector<double>& outDeriv) const;
+
+    // 提取影响无因次曲线的参数 (与 q、mu、B、h、phi、Ct、L、gamaD 无关) 及反演选项
+    QVector<double> dimensionlessKey(const ModelParams& params, const SolverOptions& options) const;
+
+    // 按精度模式与参数 N 确定实际反演阶数
+    static int resolveInversionOrder(const ModelParams& params, const SolverOptions& options);
+
     // 计算无因次压力和导数
-    void calculatePDandDeriv(const QVector<double>& tD, const QMap<QString, double>& params,
-                             std::function<double(double, const QMap<QString, double>&)> laplaceFunc,
-                             QVector<double>& outPD, QVector<double>& outDeriv);
+    void calculatePDandDeriv(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                             Report& report, QVector<double>& outPD, QVector<double>& outDeriv) const;
+
+    // 压敏修正: pD' = -ln(1 - gamaD*pD)/gamaD，导数按链式法则除以 (1 - gamaD*pD)
+    static void applyPressureSensitivity(const QVector<double>& tD, double gamaD, QVector<double>& pD, QVector<double>& dpD);
+
+    // 由类型曲线库计算无因次曲线 (库 z 范围以外的取样点直接计算)，库未覆盖该组参数时返回 false
+    bool previewPDandDeriv(const QVector<double>& tD, const ModelParams& params, const TypeCurveLibrary* library,
+                           QVector<double>& outPD, QVector<double>& outDeriv) const;
+
+    // 拉普拉斯反演得到未做压敏修正的 pD；outDeriv 非空时由同一组取样输出 dpD/dln(tD)
+    QVector<double> invertPD(const QVector<double>& tD, const ModelParams& params, const SolverOptions& options,
+                             Report& report, QVector<double>* outDeriv = nullptr) const;
 
-    // 拉普拉斯空间下的复合模型函数
-    double flaplace_composite(double z, const QMap<QString, double>& p);
+    // 先识别早期/晚期渐近段并解析计算 (tol 为渐近段容差，0 为关闭)，其余时间点 (含两个切换点) 做完整反演
+    static QVector<double> invertWithAsymptotes(const LaplaceInversion& inversion, const QVector<double>& tD,
+                                                const LaplaceInversion::RealKernel& realF,
+                                                const LaplaceInversion::ComplexKernel& complexF, double tol,
+                                                Report& report, QVector<double>* outDeriv);
 
-    // 计算点源解的拉普拉斯变换值
-    double PWD_composite(double z, double fs1, double fs2, double M12, double LfD, double rmD, double reD, int nf, const QVector<double>& xwD, ModelType type);
+    // 旧接口: 记录最近一次统计
+    void storeLastReport(const Report& report);
 
-    // 数学辅助函数
-    double scaled_besseli(int v, double x);
-    double gauss15(std::function<double(double)> f, double a, double b);
-    double adaptiveGauss(std::function<double(double)> f, double a, double b, double eps, int depth, int maxDepth);
-    double stefestCoefficient(int i, int N);
-    double factorial(int n);
+    // 拉普拉斯空间下的复合模型函数 (Model 为 CompositeModel<边界策略, 井储策略>，T 为 double 或 std::complex<double>)
+    // Params 为 ModelParams (参数为 double) 或 SensitivityParams<T> (参数为对偶数)
+    template<typename Model, typename T, typename Params>
+    static T flaplace_composite(const T& z, const Params& p);
+
+    // flaplace_composite 的两部分: 不含井储的储层解 pf(z)，及在 pf 上叠加井储与表皮
+    template<typename Model, typename T, typename Params>
+    static T reservoir_composite(const T& z, const Params& p);
+    template<typename Model, typename T, typename Params>
+    static T storage_composite(const T& z, const T& pf, const Params& p);
+
+    // 计算点源解的拉普拉斯变换值 (外边界修正由 Boundary 策略在编译期确定，P 为参数类型)
+    template<typename Boundary, typename T, typename P>
+    static T PWD_composite(const T& z, const T& fs1, const T& fs2, const P& M12, const P& LfD, const P& rmD, const P& reD, int nf, const QVector<double>& xwD);
+
+    // 由策略组合生成注册表项
+    template<typename Model>
+    static ModelKernel makeKernel(ModelType type, const char* name);
+
+    // 模型注册表 (按 ModelType 顺序)
+    static const QVector<ModelKernel>& modelRegistry();
+
+    // 对称 Toeplitz 方程组求解 (Levinson 递推)，r 为首列，f、fNew 为递推用的工作向量
+    template<typename T>
+    static bool solveSymmetricToeplitz(const QVector<T>& r, const QVector<T>& b, QVector<T>& x,
+                                       QVector<T>& f, QVector<T>& fNew);
 
 private:
     ModelType m_type;       // 当前模型类型
-    bool m_highPrecision;   // 高精度计算标志
+    const ModelKernel* m_kernel;    // 当前模型的注册表项 (核函数与特征)
+
+    SolverOptions m_options;                    // 旧接口使用的默认选项
+    Report m_lastReport;                        // 旧接口最近一次计算的统计
+    mutable QMutex m_reportMutex;               // 保护 m_lastReport
+
+    // 以下为内部缓存，不影响计算结果，const 接口中也会更新
+    mutable QList<DimensionlessEntry> m_curveCache;     // 最近使用的主曲线 (表头为最新)
+    mutable QMutex m_cacheMutex;                        // 保护主曲线缓存 (只在查找与合并时持有，反演期间不持有)
+    mutable QList<ReservoirEntry> m_reservoirCache;     // 储层核函数记忆表 (表头为最新)
+    mutable QMutex m_reservoirMutex;                    // 保护记忆表 (可在持有 m_cacheMutex 时获取，反之不可)
 };
 
 #endif // MODELSOLVER01_06_H  // 修改点：保持一致
@@ -0,0 +1,149 @@
+/*
+ * 文件名: multistartfit.cpp
+ * 文件作用: 多起点全局拟合实现文件
+ * 功能描述:
+ * 1. 每个起点一个任务，在独立线程池中并发运行 (各起点内部的残差与 Jacobian 计算可继续使用其他线程池)。
+ * 2. 共享状态只有停止标志与当前最优误差 (互斥锁保护)，各起点在每次迭代开始时检查；
+ *    取消与停止取决于各起点的相对进度，因此并发运行时结果可能随调度略有不同，未触发取消时与线程数无关。
+ */
+
+#include "multistartfit.h"
+#include "computesupport.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+QVector<Eigen::VectorXd> MultiStartFit::latinHypercube(const Eigen::VectorXd& lower, const Eigen::VectorXd& upper,
+                                                       int count, unsigned seed)
+{
+    const Eigen::Index n = std::min(lower.size(), upper.size());
+    QVector<Eigen::VectorXd> samples(std::max(0, count), Eigen::VectorXd(n));
+    if (count <= 0) return samples;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    QVector<int> strata(count);
+    for (Eigen::Index j = 0; j < n; ++j) {
+        for (int k = 0; k < count; ++k) strata[k] = k;
+        std::shuffle(strata.begin(), strata.end(), rng);
+        const double width = (upper[j] - lower[j]) / count;
+        for (int k = 0; k < count; ++k) samples[k][j] = lower[j] + (strata[k] + uniform(rng)) * width;
+    }
+    return samples;
+}
+
+QVector<MultiStartFit::Solution> MultiStartFit::run(const LevenbergMarquardt::Problem& problem, const QVector<Eigen::VectorXd>& starts,
+                                                    const Eigen::VectorXd& sampleLower, const Eigen::VectorXd& sampleUpper,
+                                                    const Settings& settings, const StopCallback& stopRequested,
+                                                    const ProgressCallback& progress, Report* report)
+{
+    const int count = starts.size();
+    QVector<LevenbergMarquardt::Result> results(count);
+    QVector<char> dominated(count, 0);
+
+    std::atomic<bool> stopAll(false);
+    QMutex mutex;
+    double best = std::numeric_limits<double>::infinity();
+    int finished = 0;
+
+    auto runStart = [&](int i) {
+        double current = std::numeric_limits<double>::infinity();
+        LevenbergMarquardt::Problem p = problem;
+        p.stepAccepted = [&](const Eigen::VectorXd&, double meanSquare) {
+            current = meanSquare;
+            QMutexLocker locker(&mutex);
+            best = std::min(best, meanSquare);
+        };
+        p.iterationStarted = [&](int iteration) {
+            if (stopAll) return false;
+            if (stopRequested && stopRequested()) {
+                stopAll = true;
+                return false;
+            }
+            if (iteration >= settings.minIterationsBeforeCancel) {
+                QMutexLocker locker(&mutex);
+                if (current > settings.dominanceRatio * best) {
+                    dominated[i] = 1;
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        results[i] = LevenbergMarquardt::minimize(p, starts[i], settings.lm);
+        if (results[i].status == LevenbergMarquardt::TargetReached) stopAll = true;
+
+        QMutexLocker locker(&mutex);
+        best = std::min(best, results[i].residualCount > 0 ? results[i].sse / results[i].residualCount : best);
+        ++finished;
+        if (progress) progress(finished, count);
+    };
+
+    const int threads = std::min(count, settings.threadCount > 0 ? settings.threadCount : QThread::idealThreadCount());
+    if (threads <= 1) {
+        for (int i = 0; i < count; ++i) runStart(i);
+    } else {
+        QVector<int> tasks(count);
+        for (int i = 0; i < count; ++i) tasks[i] = i;
+        QtConcurrent::blockingMap(ComputeSupport::pool(ComputeSupport::MultiStartPool, threads), tasks, runStart);
+    }
+
+    // 按误差排序，合并相同的解
+    QVector<int> order;
+    for (int i = 0; i < count; ++i) {
+        if (!dominated[i] && results[i].status != LevenbergMarquardt::Failed && results[i].residualCount > 0) order.append(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return results[a].sse / results[a].residualCount < results[b].sse / results[b].residualCount;
+    });
+
+    QVector<Solution> solutions;
+    for (int i : order) {
+        const LevenbergMarquardt::Result& r = results[i];
+        bool merged = false;
+        for (Solution& s : solutions) {
+            bool same = true;
+            for (Eigen::Index j = 0; j < r.x.size() && same; ++j) {
+                double width = (j < sampleLower.size() && j < sampleUpper.size()) ? sampleUpper[j] - sampleLower[j] : 0.0;
+                if (!(width > 0.0)) width = std::max(1.0, std::abs(s.x[j]));
+                same = std::abs(r.x[j] - s.x[j]) <= settings.distinctTolerance * width;
+            }
+            if (same) {
+                ++s.hits;
+                merged = true;
+                break;
+            }
+        }
+        if (merged) continue;
+
+        Solution s;
+        s.x = r.x;
+        s.meanSquare = r.sse / r.residualCount;
+        s.start = i;
+        s.iterations = r.iterations;
+        s.conditionNumber = r.conditionNumber;
+        s.status = r.status;
+        solutions.append(s);
+    }
+
+    if (report) {
+        *report = Report();
+        report->starts = count;
+        for (int i = 0; i < count; ++i) {
+            if (dominated[i]) ++report->cancelled;
+            else if (results[i].status == LevenbergMarquardt::Stopped) ++report->stopped;
+            else if (results[i].status != LevenbergMarquardt::Failed) ++report->finished;
+            report->residualEvaluations += results[i].residualEvaluations;
+            report->jacobianEvaluations += results[i].jacobianEvaluations;
+        }
+    }
+    return solutions;
+}
@@ -0,0 +1,65 @@
+/*
+ * 文件名: multistartfit.h
+ * 文件作用: 多起点全局拟合头文件 (不依赖界面)
+ * 功能描述:
+ * 1. 在优化变量的取样范围内按拉丁超立方生成起点 (调用方把对数参数表示为 log10(值)，即在对数空间均匀分层)。
+ * 2. 各起点的 LevenbergMarquardt 在独立线程池中并发运行:
+ *    任一起点达到目标误差或调用方要求停止时全部结束；迭代若干次后误差仍远大于当前最优的起点提前取消。
+ * 3. 结果按误差排序并合并相同的解 (各变量之差相对取样范围不超过容差)，记录收敛到同一解的起点数。
+ */
+
+#ifndef MULTISTARTFIT_H
+#define MULTISTARTFIT_H
+
+#include <QVector>
+#include <functional>
+#include "levenbergmarquardt.h"
+
+class MultiStartFit
+{
+public:
+    struct Settings {
+        int threadCount = 0;                // 并发运行的起点数: 0 表示 QThread::idealThreadCount()
+        int minIterationsBeforeCancel = 3;  // 至少迭代此次数后才判断是否被当前最优支配
+        double dominanceRatio = 10.0;       // 误差超过当前最优的此倍数时取消
+        double distinctTolerance = 0.02;    // 区分不同解的容差 (相对取样范围)
+        LevenbergMarquardt::Settings lm;
+    };
+
+    struct Solution {
+        Eigen::VectorXd x;
+        double meanSquare = 0.0;
+        int start = 0;                      // 得到该解的起点序号
+        int hits = 1;                       // 收敛到该解的起点数
+        int iterations = 0;
+        double conditionNumber = 0.0;
+        LevenbergMarquardt::Status status = LevenbergMarquardt::Failed;
+    };
+
+    struct Report {
+        int starts = 0;
+        int finished = 0;                   // 正常结束 (含达到目标、停滞、达到迭代上限) 的起点数
+        int cancelled = 0;                  // 被当前最优支配而取消的起点数
+        int stopped = 0;                    // 因共享停止而结束的起点数
+        int residualEvaluations = 0;
+        int jacobianEvaluations = 0;
+    };
+
+    // 已完成的起点数 / 起点总数
+    using ProgressCallback = std::function<void(int finished, int total)>;
+    // 返回 true 时全部结束
+    using StopCallback = std::function<bool()>;
+
+    // [lower, upper] 内 count 个拉丁超立方样本 (每个变量的 count 个等分区间各取一个点，区间顺序随机排列)
+    static QVector<Eigen::VectorXd> latinHypercube(const Eigen::VectorXd& lower, const Eigen::VectorXd& upper,
+                                                   int count, unsigned seed);
+
+    // problem 的残差与 Jacobian 必须可被多个线程同时调用 (其回调由本类设置，调用方的回调被忽略)；
+    // sampleLower/sampleUpper 为取样范围，用于区分不同解
+    static QVector<Solution> run(const LevenbergMarquardt::Problem& problem, const QVector<Eigen::VectorXd>& starts,
+                                 const Eigen::VectorXd& sampleLower, const Eigen::VectorXd& sampleUpper,
+                                 const Settings& settings, const StopCallback& stopRequested = StopCallback(),
+                                 const ProgressCallback& progress = ProgressCallback(), Report* report = nullptr);
+};
+
+#endif // MULTISTARTFIT_H
@@ -0,0 +1,316 @@
+/*
+ * 文件名: ratesuperposition.cpp
+ * 文件作用: 变产量叠加 (卷积) 计算实现文件
+ * 功能描述:
+ * 1. 单位产量响应表的双对数三次插值与两端幂律外推。
+ * 2. 产量变化时刻的二叉树与各节点的 Chebyshev 插值矩 (重心插值公式)。
+ * 3. 逐目标时刻遍历二叉树: 远处的节点用插值矩，近处的叶节点直接求和；目标时刻之间相互独立，
+ *    按线程交错分配，结果与线程数无关。同一遍历也可输出等效点源 (供反褶积逐行构造 Jacobian)。
+ */
+
+#include "ratesuperposition.h"
+#include "computesupport.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+// 每个线程至少分到的目标时刻数 (更少时串行计算)
+const int kMinTargetsPerThread = 256;
+}
+
+RateSuperposition::UnitResponse::UnitResponse(const QVector<double>& tau, const QVector<double>& value,
+                                              const QVector<double>& logDerivative)
+{
+    if (tau.size() < 4 || value.size() != tau.size() || logDerivative.size() != tau.size()) return;
+    if (!(tau[0] > 0.0) || !(tau[1] > tau[0])) return;
+    m_logTau0 = std::log(tau[0]);
+    m_step = std::log(tau[1] / tau[0]);
+    m_value = value;
+    m_logDerivative = logDerivative;
+}
+
+void RateSuperposition::UnitResponse::evaluate(double tau, double& value, double& rate) const
+{
+    value = 0.0;
+    rate = 0.0;
+    if (!(tau > 0.0) || !isValid()) return;
+
+    const int n = m_value.size();
+    const double u = (std::log(tau) - m_logTau0) / m_step;
+
+    // 网格以外: F ~ tau^k，k = (tau*dF/dtau)/F 取端点的值
+    if (u < 0.0 || u > n - 1) {
+        const int end = (u < 0.0) ? 0 : n - 1;
+        const double F = m_value[end];
+        const double D = m_logDerivative[end];
+        if (F > 0.0) {
+            const double k = D / F;
+            value = F * std::exp(k * (u - end) * m_step);
+            rate = k * value / tau;
+        } else {
+            value = F;
+            rate = D / tau;
+        }
+        return;
+    }
+
+    // 插值模板 i-1..i+2 限制在网格内 (网格两端各留有两个点，端部单元内 s 略超出 [0, 1])
+    const int i = std::min(std::max((int)std::floor(u), 1), n - 3);
+    const double s = u - i;
+    value = ComputeSupport::interpolateLogLog(m_value[i - 1], m_value[i], m_value[i + 1], m_value[i + 2], s);
+    const double D = ComputeSupport::interpolateLogLog(m_logDerivative[i - 1], m_logDerivative[i],
+                                                       m_logDerivative[i + 1], m_logDerivative[i + 2], s);
+    rate = D / tau;
+}
+
+RateSuperposition::RateSuperposition(const QVector<double>& changeTimes, const QVector<double>& rates)
+    : m_order(8)
+    , m_separation(0.5)
+    , m_leafSize(16)
+{
+    // 只保留产量确有变化的时刻 (增量为 0 的时刻不影响压力)
+    const int n = std::min(changeTimes.size(), rates.size());
+    double previous = 0.0;
+    for (int j = 0; j < n; ++j) {
+        if (!std::isfinite(changeTimes[j]) || !std::isfinite(rates[j])) continue;
+        const double step = rates[j] - previous;
+        previous = rates[j];
+        if (step == 0.0) continue;
+        if (!m_times.isEmpty() && changeTimes[j] < m_times.last()) continue;   // 时刻须为升序
+        m_times.append(changeTimes[j]);
+        m_steps.append(step);
+    }
+    rebuild();
+}
+
+RateSuperposition RateSuperposition::fromDurations(const QVector<double>& durations, const QVector<double>& rates,
+                                                   double startTime)
+{
+    const int n = std::min(durations.size(), rates.size());
+    QVector<double> times(n);
+    double t = startTime;
+    for (int j = 0; j < n; ++j) {
+        times[j] = t;
+        t += durations[j];
+    }
+    return RateSuperposition(times, rates.mid(0, n));
+}
+
+void RateSuperposition::setChebyshevOrder(int order)
+{
+    m_order = std::max(2, order);
+    rebuild();
+}
+
+void RateSuperposition::setSeparation(double separation)
+{
+    m_separation = separation > 0.0 ? separation : 0.5;
+}
+
+void RateSuperposition::setLeafSize(int size)
+{
+    m_leafSize = std::max(1, size);
+    rebuild();
+}
+
+bool RateSuperposition::responseRange(const QVector<double>& t, double& tauMin, double& tauMax) const
+{
+    if (m_times.isEmpty()) return false;
+    bool any = false;
+    tauMin = tauMax = 0.0;
+    for (double ti : t) {
+        // 该时刻之前最近的一次产量变化 (决定需要的最小 tau)
+        auto it = std::lower_bound(m_times.constBegin(), m_times.constEnd(), ti);
+        if (it == m_times.constBegin()) continue;
+        const double nearest = ti - *(it - 1);
+        const double farthest = ti - m_times.first();
+        if (!any) { tauMin = nearest; tauMax = farthest; any = true; }
+        tauMin = std::min(tauMin, nearest);
+        tauMax = std::max(tauMax, farthest);
+    }
+    // 极小的 tau 只出现在紧跟产量变化的点上，限制网格跨度 (更早的部分按幂律外推)
+    if (any) tauMin = std::max(tauMin, tauMax * 1e-10);
+    return any;
+}
+
+QVector<double> RateSuperposition::responseGrid(double tauMin, double tauMax, int pointsPerDecade)
+{
+    QVector<double> grid;
+    if (!(tauMin > 0.0) || !(tauMax >= tauMin) || pointsPerDecade <= 0) return grid;
+    const double step = 1.0 / pointsPerDecade;
+    const int lo = (int)std::floor(std::log10(tauMin) / step) - 2;
+    const int hi = (int)std::ceil(std::log10(tauMax) / step) + 2;
+    grid.reserve(hi - lo + 1);
+    for (int k = lo; k <= hi; ++k) grid.append(std::pow(10.0, k * step));
+    return grid;
+}
+
+void RateSuperposition::rebuild()
+{
+    m_nodes.clear();
+    m_moments.clear();
+    m_chebyshev.resize(m_order);
+    for (int m = 0; m < m_order; ++m) m_chebyshev[m] = std::cos((2.0 * m + 1.0) * M_PI / (2.0 * m_order));
+    if (m_times.isEmpty()) return;
+
+    buildNode(0, m_times.size() - 1);
+
+    // 插值矩 W_m = sum_j dq_j * L_m(x_j)，L_m 为 Chebyshev 节点上的 Lagrange 基 (重心公式)
+    QVector<double> weights(m_order);
+    for (int m = 0; m < m_order; ++m) {
+        weights[m] = ((m % 2) ? -1.0 : 1.0) * std::sin((2.0 * m + 1.0) * M_PI / (2.0 * m_order));
+    }
+    m_moments = QVector<double>(m_nodes.size() * m_order, 0.0);
+    QVector<double> basis(m_order);
+    for (int k = 0; k < m_nodes.size(); ++k) {
+        const Node& node = m_nodes[k];
+        double* W = m_moments.data() + k * m_order;
+        const double half = 0.5 * (node.b - node.a);
+        if (half <= 0.0) {
+            // 所有变化时刻相同: 按点源处理，只用第一个矩
+            for (int j = node.first; j <= node.last; ++j) W[0] += m_steps[j];
+            continue;
+        }
+        const double mid = 0.5 * (node.a + node.b);
+        for (int j = node.first; j <= node.last; ++j) {
+            const double x = (m_times[j] - mid) / half;
+            int exact = -1;
+            double sum = 0.0;
+            for (int m = 0; m < m_order; ++m) {
+                const double d = x - m_chebyshev[m];
+                if (std::abs(d) < 1e-14) { exact = m; break; }
+                basis[m] = weights[m] / d;
+                sum += basis[m];
+            }
+            if (exact >= 0) {
+                W[exact] += m_steps[j];
+            } else {
+                for (int m = 0; m < m_order; ++m) W[m] += m_steps[j] * basis[m] / sum;
+            }
+        }
+    }
+}
+
+int RateSuperposition::buildNode(int first, int last)
+{
+    const int index = m_nodes.size();
+    Node node;
+    node.first = first;
+    node.last = last;
+    node.a = m_times[first];
+    node.b = m_times[last];
+    m_nodes.append(node);
+    if (last - first + 1 > m_leafSize) {
+        const int split = (first + last) / 2;
+        const int left = buildNode(first, split);
+        const int right = buildNode(split + 1, last);
+        m_nodes[index].left = left;
+        m_nodes[index].right = right;
+    }
+    return index;
+}
+
+template<typename Visit>
+void RateSuperposition::visitSources(double t, Visit visit) const
+{
+    if (m_nodes.isEmpty()) return;
+
+    int stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const int k = stack[--top];
+        const Node& node = m_nodes[k];
+        if (node.a >= t) continue;                  // 全部在目标时刻之后
+
+        const double half = 0.5 * (node.b - node.a);
+        if (node.b < t && 2.0 * half <= m_separation * (t - node.b)) {
+            // 远处: Chebyshev 节点上的插值矩
+            const double* W = m_moments.constData() + k * m_order;
+            if (half <= 0.0) {
+                visit(node.a, W[0]);
+                continue;
+            }
+            const double mid = 0.5 * (node.a + node.b);
+            for (int m = 0; m < m_order; ++m) visit(mid + half * m_chebyshev[m], W[m]);
+        } else if (node.left < 0) {
+            // 近处的叶节点: 各次产量变化本身
+            for (int j = node.first; j <= node.last && m_times[j] < t; ++j) visit(m_times[j], m_steps[j]);
+        } else {
+            stack[top++] = node.right;
+            stack[top++] = node.left;
+        }
+    }
+}
+
+void RateSuperposition::evaluateAt(const UnitResponse& unit, double t, double& value, double& rate) const
+{
+    value = 0.0;
+    rate = 0.0;
+    double F, G;
+    visitSources(t, [&](double time, double weight) {
+        unit.evaluate(t - time, F, G);
+        value += weight * F;
+        rate += weight * G;
+    });
+}
+
+void RateSuperposition::sources(double t, QVector<double>& times, QVector<double>& weights) const
+{
+    times.clear();
+    weights.clear();
+    visitSources(t, [&](double time, double weight) {
+        times.append(time);
+        weights.append(weight);
+    });
+}
+
+ModelCurveData RateSuperposition::superpose(const UnitResponse& unit, const QVector<double>& t) const
+{
+    const int n = t.size();
+    QVector<double> dp(n, 0.0), deriv(n, 0.0);
+    auto evaluate = [&](int i) {
+        double value, rate;
+        evaluateAt(unit, t[i], value, rate);
+        dp[i] = value;
+        deriv[i] = t[i] * rate;
+    };
+
+    const int threads = std::min(QThread::idealThreadCount(), n / kMinTargetsPerThread);
+    if (threads <= 1) {
+        for (int i = 0; i < n; ++i) evaluate(i);
+    } else {
+        QVector<int> tasks(threads);
+        for (int j = 0; j < threads; ++j) tasks[j] = j;
+        QtConcurrent::blockingMap(ComputeSupport::pool(ComputeSupport::SuperpositionPool, threads), tasks, [&](int j) {
+            for (int i = j; i < n; i += threads) evaluate(i);
+        });
+    }
+    return std::make_tuple(t, dp, deriv);
+}
+
+ModelCurveData RateSuperposition::superposeDirect(const UnitResponse& unit, const QVector<double>& t) const
+{
+    const int n = t.size();
+    QVector<double> dp(n, 0.0), deriv(n, 0.0);
+    double F, G;
+    for (int i = 0; i < n; ++i) {
+        double value = 0.0, rate = 0.0;
+        for (int j = 0; j < m_times.size() && m_times[j] < t[i]; ++j) {
+            unit.evaluate(t[i] - m_times[j], F, G);
+            value += m_steps[j] * F;
+            rate += m_steps[j] * G;
+        }
+        dp[i] = value;
+        deriv[i] = t[i] * rate;
+    }
+    return std::make_tuple(t, dp, deriv);
+}
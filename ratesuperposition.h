@@ -0,0 +1,104 @@
+/*
+ * 文件名: ratesuperposition.h
+ * 文件作用: 变产量叠加 (卷积) 计算头文件
+ * 功能描述:
+ * 1. 由分段恒定的产量历史与单位产量响应 F(tau) 计算变产量下的压差:
+ *    dp(t) = sum_j (q_j - q_{j-1}) * F(t - t_j)，同时输出 t*d(dp)/dt。
+ * 2. 单位产量响应只需在对数等距的 tau 网格上由求解器计算一次 (与产量变化次数无关)，
+ *    网格之间在双对数坐标下做三次插值。
+ * 3. 快速求和: 产量变化时刻按二叉树分组，每组预先计算 Chebyshev 插值矩；与目标时刻相距足够远的组
+ *    (组长 <= separation * 距离) 只需在 p 个插值节点上计算 F，近处的组直接求和。
+ *    总代价约为 O((目标点数 + 产量变化次数) * p * log n)，而非逐项求和的 O(目标点数 * 产量变化次数)。
+ * 4. 产量历史可由时长序列构造，与 CurveInfo 的 x2Data (各段时长) / y2Data (各段产量) 格式一致。
+ * 5. 等效点源: 同一棵树给出任一时刻的 (时刻, 权重) 列表，调用方可用自己的响应函数求和 (如反褶积)。
+ */
+
+#ifndef RATESUPERPOSITION_H
+#define RATESUPERPOSITION_H
+
+#include <QVector>
+#include "modelsolver01-06.h"
+
+class RateSuperposition
+{
+public:
+    // 单位产量响应表: tau 为对数等距网格 (升序)，value 为 F(tau)，logDerivative 为 tau*dF/dtau
+    class UnitResponse
+    {
+    public:
+        UnitResponse() = default;
+        UnitResponse(const QVector<double>& tau, const QVector<double>& value, const QVector<double>& logDerivative);
+
+        bool isValid() const { return m_value.size() >= 4; }
+
+        // F(tau) 与 dF/dtau；tau <= 0 时为 0，超出网格时按端点的幂律外推
+        void evaluate(double tau, double& value, double& rate) const;
+
+    private:
+        double m_logTau0 = 0.0;     // ln(tau_0)
+        double m_step = 1.0;        // 相邻网格点的 ln(tau) 间距
+        QVector<double> m_value;
+        QVector<double> m_logDerivative;
+    };
+
+    // changeTimes 为升序的产量变化时刻，rates[j] 为 [changeTimes[j], changeTimes[j+1]) 内的产量
+    RateSuperposition(const QVector<double>& changeTimes, const QVector<double>& rates);
+
+    // 由各段时长构造 (第 j 段从 startTime + durations[0..j-1] 之和开始)
+    static RateSuperposition fromDurations(const QVector<double>& durations, const QVector<double>& rates,
+                                           double startTime = 0.0);
+
+    // Chebyshev 插值节点数 p (默认 8)、远近分界 separation (组长/距离，默认 0.5)、叶节点的变化次数上限 (默认 16)
+    void setChebyshevOrder(int order);
+    void setSeparation(double separation);
+    void setLeafSize(int size);
+
+    bool isValid() const { return !m_times.isEmpty(); }
+    int changeCount() const { return m_times.size(); }
+
+    // 在时刻 t 上叠加所需的单位响应 tau 范围 (返回 false 表示没有时刻位于第一次产量变化之后)
+    bool responseRange(const QVector<double>& t, double& tauMin, double& tauMax) const;
+    // 覆盖 [tauMin, tauMax] 的对数等距网格 (两端各多出两个点，保证插值模板完整)
+    static QVector<double> responseGrid(double tauMin, double tauMax, int pointsPerDecade = 20);
+
+    // 快速叠加: 返回 <t, dp, t*d(dp)/dt>，可在多个线程同时调用
+    ModelCurveData superpose(const UnitResponse& unit, const QVector<double>& t) const;
+    // 逐项求和 (校验用)
+    ModelCurveData superposeDirect(const UnitResponse& unit, const QVector<double>& t) const;
+
+    // 时刻 t 的等效点源: dp(t) ≈ sum_k weights[k] * F(t - times[k])，近处为各次产量变化本身，
+    // 远处的组为其 Chebyshev 节点与插值矩；个数约为 O(p log n)，且与 F 无关、对 F 是线性的
+    void sources(double t, QVector<double>& times, QVector<double>& weights) const;
+
+private:
+    struct Node {
+        int first = 0;      // 变化时刻下标范围 [first, last]
+        int last = -1;
+        double a = 0.0;     // 时间范围 [a, b]
+        double b = 0.0;
+        int left = -1;      // 子节点 (叶节点为 -1)
+        int right = -1;
+    };
+
+    void rebuild();
+    int buildNode(int first, int last);
+    // 遍历时刻 t 的等效点源 visit(时刻, 权重)
+    template<typename Visit>
+    void visitSources(double t, Visit visit) const;
+    // 单个目标时刻的叠加 (value 为 dp，rate 为 d(dp)/dt)
+    void evaluateAt(const UnitResponse& unit, double t, double& value, double& rate) const;
+
+private:
+    QVector<double> m_times;        // 产量变化时刻 (只保留产量确有变化的时刻)
+    QVector<double> m_steps;        // 对应的产量增量 q_j - q_{j-1}
+
+    int m_order;
+    double m_separation;
+    int m_leafSize;
+
+    QVector<Node> m_nodes;          // m_nodes[0] 为根节点
+    QVector<double> m_moments;      // 各节点的 Chebyshev 插值矩 (每节点 m_order 个)
+    QVector<double> m_chebyshev;    // [-1, 1] 上的 Chebyshev 节点
+};
+
+#endif // RATESUPERPOSITION_H
@@ -0,0 +1,554 @@
+/*
+ * 文件名: typecurvelibrary.cpp
+ * 文件作用: 无因次类型曲线库实现
+ * 功能描述:
+ * 1. 库文件布局: 文件头 + 定长块描述表 + 各块的参数轴节点 (double) 与 ln(pf) 数据 (float)，
+ *    数据按 [M12][LfD][rmD][omega1][omega2][lambda1][reD][z] 行优先存放，每个网格节点的 z 曲线连续。
+ * 2. 生成: 各块的网格节点分批交给线程池计算，写文件后回填各块的校验误差；
+ *    封闭/定压边界中 reD <= rmD 的节点无解，整条 z 曲线记为 NaN；核函数在极端 z 上溢出的点也记为 NaN。
+ *    查询只使用插值模板内全部有效的 z 段，所需范围未被覆盖时由求解器回退精确计算。
+ * 3. 查询: prepare 中按各轴的 Hermite 权重对模板内节点的 ln(pf) 曲线加权求和 (只取所需的 z 段)，
+ *    按 z 取值只做 Catmull-Rom 插值。
+ */
+
+#include "typecurvelibrary.h"
+#include "computesupport.h"
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QDebug>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <algorithm>
+
+namespace {
+
+// 文件头 (字节序标记按生成机器的本机字节序写入，读取时不一致即拒绝)
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    quint32 blockCount;
+    quint32 reserved[3];
+};
+
+// 块描述 (定长 128 字节)
+struct BlockHeader {
+    qint32 boundary;
+    qint32 nf;
+    qint32 zCount;
+    qint32 axisCount;
+    double zMinLog10;
+    double zStepLog10;
+    qint32 axisSize[TypeCurveLibrary::AxisCount];
+    qint32 axisLog[TypeCurveLibrary::AxisCount];
+    qint64 axisOffset;      // 参数轴节点 (double) 的文件偏移
+    qint64 dataOffset;      // ln(pf) 数据 (float) 的文件偏移
+    qint64 valueCount;      // 数据个数 = 各轴节点数之积 * zCount
+    double validationError; // 生成时抽样估计的 pf 最大相对插值误差
+    qint32 reserved[2];
+};
+
+static_assert(sizeof(FileHeader) == 32, "unexpected FileHeader layout");
+static_assert(sizeof(BlockHeader) == 128, "unexpected BlockHeader layout");
+
+const char kMagic[8] = {'W', 'T', 'T', 'C', 'L', 'I', 'B', '\0'};
+const quint32 kByteOrderMark = 0x01020304;
+const int kGenerationBatch = 256;       // 每批交给线程池的网格节点数
+const int kValidationSamples = 64;      // 每块校验的随机参数点数
+const quint32 kValidationSeed = 20240601;
+
+// 网格节点对应的参数块 (kf = M12、km = 1，物理参数不进入 pf)
+ModelParams nodeParams(const double values[TypeCurveLibrary::AxisCount], int nf)
+{
+    ModelParams p;
+    p.kf = values[TypeCurveLibrary::AxisM12];
+    p.km = 1.0;
+    p.LfD = values[TypeCurveLibrary::AxisLfD];
+    p.rmD = values[TypeCurveLibrary::AxisRmD];
+    p.omega1 = values[TypeCurveLibrary::AxisOmega1];
+    p.omega2 = values[TypeCurveLibrary::AxisOmega2];
+    p.lambda1 = values[TypeCurveLibrary::AxisLambda1];
+    p.reD = values[TypeCurveLibrary::AxisReD];
+    p.nf = nf;
+    p.updateDerived();
+    return p;
+}
+
+// 计算一个网格节点的 ln(pf) 曲线 (参数无解时整条置 NaN；个别 z 上核函数溢出或非正时该点置 NaN)
+void computeNode(const ModelSolver01_06::ModelKernel& kernel, const ModelParams& p,
+                 double zMinLog10, double zStepLog10, int zCount, float* out)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    if (kernel.bounded && !(p.reD > p.rmD)) {
+        std::fill(out, out + zCount, nan);
+        return;
+    }
+    for (int iz = 0; iz < zCount; ++iz) {
+        double z = std::pow(10.0, zMinLog10 + iz * zStepLog10);
+        double pf = kernel.reservoirReal(z, p);
+        out[iz] = (pf > 0.0 && std::isfinite(pf)) ? float(std::log(pf)) : nan;
+    }
+}
+
+// 外边界对应的注册表项 (pf 与井储策略无关，取第一个匹配项)
+const ModelSolver01_06::ModelKernel* kernelFor(ModelSolver01_06::BoundaryType boundary)
+{
+    for (ModelSolver01_06::ModelType type : ModelSolver01_06::registeredModels()) {
+        const ModelSolver01_06::ModelKernel& k = ModelSolver01_06::modelKernel(type);
+        if (k.boundary == boundary) return &k;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// 默认网格: 围绕 ModelManager 缺省参数 (M12 = 10, LfD = 0.1, rmD = 4, omega1 = 0.4, omega2 = 0.08, lambda1 = 1e-3)。
+// rmD 与 reD 决定流动阶段转换的时间 (约 rmD^2、reD^2)，插值误差对其节点间距最敏感，节点取得较密；
+// nf 只制表缺省值 4 (每个 nf 约 100 MB)，其余 nf 的预览回退精确计算，需要时在 nfValues 中增加
+TypeCurveLibrary::GenerationSpec TypeCurveLibrary::GenerationSpec::defaultSpec()
+{
+    GenerationSpec spec;
+    spec.axes[AxisM12].nodes = {1.0, 3.0, 10.0, 30.0, 100.0};
+    spec.axes[AxisLfD].nodes = {0.02, 0.05, 0.1, 0.2, 0.5};
+    spec.axes[AxisRmD].nodes = {1.5, 2.0, 3.0, 4.0, 6.0, 9.0};
+    spec.axes[AxisOmega1].nodes = {0.05, 0.1, 0.2, 0.4, 0.8};
+    spec.axes[AxisOmega2].nodes = {0.01, 0.03, 0.1, 0.3};
+    spec.axes[AxisLambda1].nodes = {1e-5, 1e-4, 1e-3, 1e-2, 1e-1};
+    spec.axes[AxisReD].nodes = {20.0, 50.0, 125.0, 300.0};
+    spec.nfValues = {4};
+    return spec;
+}
+
+// ---------------- 查询 ----------------
+
+double TypeCurveLibrary::Query::zMin() const
+{
+    // Catmull-Rom 需要两侧各一个节点，首尾节点只作为模板
+    return std::pow(10.0, m_zMinLog10 + (m_first + 1) * m_zStepLog10);
+}
+
+double TypeCurveLibrary::Query::zMax() const
+{
+    return std::pow(10.0, m_zMinLog10 + (m_first + m_logPf.size() - 2) * m_zStepLog10);
+}
+
+double TypeCurveLibrary::Query::operator()(double z) const
+{
+    const int count = m_logPf.size();
+    if (count < 4 || !(z > 0.0)) return std::numeric_limits<double>::quiet_NaN();
+    const double u = (std::log10(z) - m_zMinLog10) / m_zStepLog10 - m_first;
+    if (u < 1.0 - 1e-9 || u > count - 2 + 1e-9) return std::numeric_limits<double>::quiet_NaN();
+    const int i = qBound(1, int(std::floor(u)), count - 3);
+    const double s = u - i;
+
+    const double* l = m_logPf.constData() + (i - 1);
+    return std::exp(ComputeSupport::catmullRom(l[0], l[1], l[2], l[3], s));
+}
+
+// 在块内插值 (超出节点范围、模板含无解节点时返回无效查询)。
+// 每个轴在所在区间 [x1, x2] 上做三次 Hermite 插值，斜率取 (y2-y0)/(x2-x0) 与 (y3-y1)/(x3-x1)，
+// 端部区间缺少外侧节点时取相邻三个节点的抛物线斜率；只有两个节点的轴为线性插值。
+// 各轴权重相乘后对模板内的节点曲线加权求和
+TypeCurveLibrary::Query TypeCurveLibrary::prepareBlock(const Block& block, const double values[AxisCount],
+                                                       double zLo, double zHi)
+{
+    Query query;
+
+    // 各轴的模板节点与权重 (至多 4 个)
+    int stencilSize[AxisCount];
+    int stencilIndex[AxisCount][4];
+    double stencilWeight[AxisCount][4];
+    for (int a = 0; a < AxisCount; ++a) {
+        const double* nodes = block.axisNodes[a];
+        const int n = block.axisSize[a];
+        const double v = values[a];
+        stencilSize[a] = 1;
+        stencilIndex[a][0] = 0;
+        stencilWeight[a][0] = 1.0;
+        if (n == 1) {
+            // 单节点轴: 须与节点一致；无限大边界的 reD 轴不参与计算
+            const bool unused = (a == AxisReD && block.boundary == ModelSolver01_06::Infinite);
+            if (!unused && std::abs(v - nodes[0]) > 1e-9 * std::max(1.0, std::abs(nodes[0]))) return query;
+            continue;
+        }
+        const double slack = 1e-12 * std::max(std::abs(nodes[0]), std::abs(nodes[n - 1]));
+        if (!(v >= nodes[0] - slack) || !(v <= nodes[n - 1] + slack)) return query;
+        if (block.axisLog[a] && !(v > 0.0)) return query;
+
+        auto coord = [&](int k) { return block.axisLog[a] ? std::log(nodes[k]) : nodes[k]; };
+        const int k = qBound(0, int(std::upper_bound(nodes, nodes + n, v) - nodes) - 1, n - 2);
+        const double x1 = coord(k), x2 = coord(k + 1);
+        const double h = x2 - x1;
+        const double t = qBound(0.0, ((block.axisLog[a] ? std::log(v) : v) - x1) / h, 1.0);
+        const double t2 = t * t, t3 = t2 * t;
+        const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0, h10 = t3 - 2.0 * t2 + t;
+        const double h01 = -2.0 * t3 + 3.0 * t2, h11 = t3 - t2;
+
+        // 两端斜率对节点 k-1 .. k+2 的系数 (y' = sum d[j]*y[j])
+        double d1[4] = {0.0, 0.0, 0.0, 0.0};
+        double d2[4] = {0.0, 0.0, 0.0, 0.0};
+        if (k > 0) {
+            const double x0 = coord(k - 1);
+            d1[2] = 1.0 / (x2 - x0);
+            d1[0] = -d1[2];
+        } else if (k + 2 < n) {
+            // 左端区间: 过 k、k+1、k+2 的抛物线在 x1 处的斜率
+            const double x3 = coord(k + 2);
+            d1[1] = (2.0 * x1 - x2 - x3) / ((x1 - x2) * (x1 - x3));
+            d1[2] = (x1 - x3) / ((x2 - x1) * (x2 - x3));
+            d1[3] = (x1 - x2) / ((x3 - x1) * (x3 - x2));
+        } else {
+            d1[2] = 1.0 / h;
+            d1[1] = -d1[2];
+        }
+        if (k + 2 < n) {
+            const double x3 = coord(k + 2);
+            d2[3] = 1.0 / (x3 - x1);
+            d2[1] = -d2[3];
+        } else if (k > 0) {
+            // 右端区间: 过 k-1、k、k+1 的抛物线在 x2 处的斜率
+            const double x0 = coord(k - 1);
+            d2[0] = (x2 - x1) / ((x0 - x1) * (x0 - x2));
+            d2[1] = (x2 - x0) / ((x1 - x0) * (x1 - x2));
+            d2[2] = (2.0 * x2 - x0 - x1) / ((x2 - x0) * (x2 - x1));
+        } else {
+            d2[2] = 1.0 / h;
+            d2[1] = -d2[2];
+        }
+        double w[4];
+        for (int j = 0; j < 4; ++j) w[j] = h * (h10 * d1[j] + h11 * d2[j]);
+        w[1] += h00;
+        w[2] += h01;
+        int m = 0;
+        for (int j = 0; j < 4; ++j) {
+            const int node = k - 1 + j;
+            if (w[j] == 0.0 || node < 0 || node >= n) continue;
+            stencilIndex[a][m] = node;
+            stencilWeight[a][m] = w[j];
+            ++m;
+        }
+        stencilSize[a] = m;
+    }
+
+    // 需要插值的 z 节点 (含 Catmull-Rom 两侧模板)
+    const double uLo = zLo > 0.0 ? (std::log10(zLo) - block.zMinLog10) / block.zStepLog10 : 0.0;
+    const double uHi = std::isfinite(zHi) ? (std::log10(zHi) - block.zMinLog10) / block.zStepLog10 : block.zCount;
+    const int first = qBound(0, int(std::floor(uLo)) - 1, block.zCount - 4);
+    const int last = qBound(first + 3, int(std::ceil(uHi)) + 1, block.zCount - 1);
+    const int count = last - first + 1;
+
+    // 遍历各轴模板的组合 (按轴展开的多重循环)，节点数据行优先存放
+    QVector<double> logPf(count, 0.0);
+    int digit[AxisCount] = {};
+    for (;;) {
+        double w = 1.0;
+        qint64 index = 0;
+        for (int a = 0; a < AxisCount; ++a) {
+            w *= stencilWeight[a][digit[a]];
+            index = index * block.axisSize[a] + stencilIndex[a][digit[a]];
+        }
+        const float* row = block.data + index * block.zCount + first;
+        for (int iz = 0; iz < count; ++iz) logPf[iz] += w * row[iz];
+
+        int a = AxisCount - 1;
+        while (a >= 0 && ++digit[a] == stencilSize[a]) digit[a--] = 0;
+        if (a < 0) break;
+    }
+
+    // 模板内有 NaN 的 z 点结果为 NaN，取最长的连续有效段 (由调用方检查 zMin、zMax 是否覆盖所需范围)
+    int bestStart = 0, bestLength = 0;
+    for (int iz = 0; iz < count;) {
+        if (!std::isfinite(logPf[iz])) { ++iz; continue; }
+        int end = iz;
+        while (end < count && std::isfinite(logPf[end])) ++end;
+        if (end - iz > bestLength) { bestStart = iz; bestLength = end - iz; }
+        iz = end;
+    }
+    if (bestLength < 4) return query;
+
+    query.m_logPf = logPf.mid(bestStart, bestLength);
+    query.m_first = first + bestStart;
+    query.m_zMinLog10 = block.zMinLog10;
+    query.m_zStepLog10 = block.zStepLog10;
+    query.m_validationError = block.validationError;
+    return query;
+}
+
+// ---------------- 打开与关闭 ----------------
+
+TypeCurveLibrary::TypeCurveLibrary()
+    : m_map(nullptr)
+    , m_size(0)
+{
+}
+
+TypeCurveLibrary::~TypeCurveLibrary()
+{
+    close();
+}
+
+bool TypeCurveLibrary::open(const QString& path, QString* error)
+{
+    close();
+    auto fail = [this, error](const QString& msg) {
+        if (error) *error = msg;
+        close();
+        return false;
+    };
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) return fail("无法打开类型曲线库: " + m_file.errorString());
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(FileHeader))) return fail("类型曲线库文件不完整");
+    m_map = m_file.map(0, m_size);
+    if (!m_map) return fail("类型曲线库内存映射失败: " + m_file.errorString());
+
+    FileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return fail("不是类型曲线库文件");
+    if (header.byteOrder != kByteOrderMark) return fail("类型曲线库的字节序与本机不一致，请重新生成");
+    if (header.version != kVersion) return fail(QString("类型曲线库版本 %1 与程序版本 %2 不一致，请重新生成")
+                                                    .arg(int(header.version)).arg(int(kVersion)));
+    const qint64 tableEnd = qint64(sizeof(FileHeader)) + qint64(header.blockCount) * qint64(sizeof(BlockHeader));
+    if (tableEnd > m_size) return fail("类型曲线库文件不完整");
+
+    for (quint32 b = 0; b < header.blockCount; ++b) {
+        BlockHeader bh;
+        std::memcpy(&bh, m_map + sizeof(FileHeader) + b * sizeof(BlockHeader), sizeof(bh));
+
+        qint64 axisTotal = 0;
+        qint64 nodeCount = 1;
+        bool axesOk = (bh.axisCount == AxisCount) && bh.zCount >= 4 && bh.zStepLog10 > 0.0;
+        for (int a = 0; axesOk && a < AxisCount; ++a) {
+            axesOk = bh.axisSize[a] >= 1;
+            axisTotal += bh.axisSize[a];
+            nodeCount *= bh.axisSize[a];
+        }
+        if (!axesOk || bh.valueCount != nodeCount * bh.zCount
+            || bh.axisOffset < tableEnd || bh.axisOffset % qint64(sizeof(double)) != 0
+            || bh.axisOffset + axisTotal * qint64(sizeof(double)) > m_size
+            || bh.dataOffset < tableEnd || bh.dataOffset % qint64(sizeof(float)) != 0
+            || bh.dataOffset + bh.valueCount * qint64(sizeof(float)) > m_size) {
+            return fail(QString("类型曲线库第 %1 块的描述无效").arg(int(b)));
+        }
+
+        Block block;
+        block.boundary = bh.boundary;
+        block.nf = bh.nf;
+        block.zCount = bh.zCount;
+        block.zMinLog10 = bh.zMinLog10;
+        block.zStepLog10 = bh.zStepLog10;
+        const double* axisData = reinterpret_cast<const double*>(m_map + bh.axisOffset);
+        for (int a = 0; a < AxisCount; ++a) {
+            block.axisNodes[a] = axisData;
+            block.axisSize[a] = bh.axisSize[a];
+            block.axisLog[a] = bh.axisLog[a] != 0;
+            axisData += bh.axisSize[a];
+        }
+        block.data = reinterpret_cast<const float*>(m_map + bh.dataOffset);
+        block.validationError = bh.validationError;
+        m_blocks.append(block);
+    }
+    return true;
+}
+
+void TypeCurveLibrary::close()
+{
+    m_blocks.clear();
+    if (m_map) m_file.unmap(m_map);
+    m_map = nullptr;
+    m_size = 0;
+    if (m_file.isOpen()) m_file.close();
+}
+
+const TypeCurveLibrary::Block* TypeCurveLibrary::findBlock(ModelSolver01_06::BoundaryType boundary, int nf) const
+{
+    for (const Block& block : m_blocks) {
+        if (block.boundary == boundary && block.nf == nf) return &block;
+    }
+    return nullptr;
+}
+
+TypeCurveLibrary::Query TypeCurveLibrary::prepare(ModelSolver01_06::BoundaryType boundary, const ModelParams& params,
+                                                  double zLo, double zHi) const
+{
+    const Block* block = findBlock(boundary, params.nf);
+    if (!block) return Query();
+    double values[AxisCount];
+    values[AxisM12] = params.M12;
+    values[AxisLfD] = params.LfD;
+    values[AxisRmD] = params.rmD;
+    values[AxisOmega1] = params.omega1;
+    values[AxisOmega2] = params.omega2;
+    values[AxisLambda1] = params.lambda1;
+    values[AxisReD] = params.reD;
+    return prepareBlock(*block, values, zLo, zHi);
+}
+
+// ---------------- 离线生成 ----------------
+
+// 按块依次计算并写出: 先写文件头与块描述表 (校验误差暂为 0)，各块数据写完后回填描述表
+bool TypeCurveLibrary::generate(const QString& path, const GenerationSpec& spec, QString* error,
+                                const std::function<void(int, int)>& progress)
+{
+    auto fail = [error](const QString& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    const int zCount = int(std::floor((spec.zMaxLog10 - spec.zMinLog10) * spec.zPerDecade + 0.5)) + 1;
+    if (spec.zPerDecade < 1 || zCount < 4) return fail("z 网格至少需要 4 个节点");
+    const double zStep = 1.0 / spec.zPerDecade;
+    for (int a = 0; a < AxisCount; ++a) {
+        const QVector<double>& nodes = spec.axes[a].nodes;
+        if (nodes.isEmpty()) return fail(QString("参数轴 %1 没有节点").arg(a));
+        for (int i = 0; i < nodes.size(); ++i) {
+            if (i > 0 && !(nodes[i] > nodes[i - 1])) return fail(QString("参数轴 %1 的节点须严格递增").arg(a));
+            if (spec.axes[a].logScale && !(nodes[i] > 0.0)) return fail(QString("对数参数轴 %1 的节点须为正").arg(a));
+        }
+    }
+    if (spec.nfValues.isEmpty()) return fail("未指定裂缝条数 nf");
+
+    // 块描述: 外边界 × nf (无限大边界的 reD 轴只有一个节点)
+    const ModelSolver01_06::BoundaryType boundaries[] = {
+        ModelSolver01_06::Infinite, ModelSolver01_06::Closed, ModelSolver01_06::ConstantPressure
+    };
+    QVector<BlockHeader> headers;
+    QVector<QVector<double>> blockAxes;
+    qint64 offset = qint64(sizeof(FileHeader)) + qint64(3 * spec.nfValues.size()) * qint64(sizeof(BlockHeader));
+    qint64 totalNodes = 0;
+    for (ModelSolver01_06::BoundaryType boundary : boundaries) {
+        for (int nf : spec.nfValues) {
+            BlockHeader bh;
+            std::memset(&bh, 0, sizeof(bh));
+            bh.boundary = boundary;
+            bh.nf = nf;
+            bh.zCount = zCount;
+            bh.axisCount = AxisCount;
+            bh.zMinLog10 = spec.zMinLog10;
+            bh.zStepLog10 = zStep;
+            QVector<double> axes;
+            qint64 nodeCount = 1;
+            for (int a = 0; a < AxisCount; ++a) {
+                QVector<double> nodes = spec.axes[a].nodes;
+                if (a == AxisReD && boundary == ModelSolver01_06::Infinite) nodes = QVector<double>(1, 0.0);
+                bh.axisSize[a] = nodes.size();
+                bh.axisLog[a] = (spec.axes[a].logScale && nodes.size() > 1) ? 1 : 0;
+                nodeCount *= nodes.size();
+                for (double v : nodes) axes.append(v);
+            }
+            bh.axisOffset = offset;
+            offset += axes.size() * qint64(sizeof(double));
+            bh.dataOffset = offset;
+            bh.valueCount = nodeCount * zCount;
+            offset += bh.valueCount * qint64(sizeof(float));
+            offset = (offset + 7) / 8 * 8;     // 下一块的 double 轴数据按 8 字节对齐
+            headers.append(bh);
+            blockAxes.append(axes);
+            totalNodes += nodeCount;
+        }
+    }
+    if (totalNodes > std::numeric_limits<int>::max()) return fail("网格节点过多");
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return fail("无法写入类型曲线库: " + file.errorString());
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.blockCount = quint32(headers.size());
+    auto writeRaw = [&file](const void* data, qint64 size) {
+        return file.write(reinterpret_cast<const char*>(data), size) == size;
+    };
+    bool ok = writeRaw(&header, sizeof(header));
+    for (const BlockHeader& bh : headers) ok = ok && writeRaw(&bh, sizeof(bh));
+    if (!ok) return fail("写入类型曲线库失败: " + file.errorString());
+
+    int done = 0;
+    std::mt19937 rng(kValidationSeed);
+    for (int b = 0; b < headers.size(); ++b) {
+        BlockHeader& bh = headers[b];
+        const ModelSolver01_06::BoundaryType boundary = ModelSolver01_06::BoundaryType(bh.boundary);
+        const ModelSolver01_06::ModelKernel* kernel = kernelFor(boundary);
+        if (!kernel) return fail("模型注册表中没有对应外边界的模型");
+
+        // 本块的轴与节点下标换算
+        Block block;
+        block.boundary = bh.boundary;
+        block.nf = bh.nf;
+        block.zCount = zCount;
+        block.zMinLog10 = bh.zMinLog10;
+        block.zStepLog10 = bh.zStepLog10;
+        const double* axisData = blockAxes[b].constData();
+        for (int a = 0; a < AxisCount; ++a) {
+            block.axisNodes[a] = axisData;
+            block.axisSize[a] = bh.axisSize[a];
+            block.axisLog[a] = bh.axisLog[a] != 0;
+            axisData += bh.axisSize[a];
+        }
+        const int nodeCount = int(bh.valueCount / zCount);
+        auto nodeValues = [&block](int node, double values[AxisCount]) {
+            for (int a = AxisCount - 1; a >= 0; --a) {
+                values[a] = block.axisNodes[a][node % block.axisSize[a]];
+                node /= block.axisSize[a];
+            }
+        };
+
+        // 分批并行计算，回调进度
+        QVector<float> data(int(bh.valueCount));
+        for (int start = 0; start < nodeCount; start += kGenerationBatch) {
+            QVector<int> batch;
+            for (int n = start; n < std::min(nodeCount, start + kGenerationBatch); ++n) batch.append(n);
+            QtConcurrent::blockingMap(batch, [&](const int& node) {
+                double values[AxisCount];
+                nodeValues(node, values);
+                computeNode(*kernel, nodeParams(values, bh.nf), bh.zMinLog10, bh.zStepLog10, zCount,
+                            data.data() + qint64(node) * zCount);
+            });
+            done += batch.size();
+            if (progress) progress(done, int(totalNodes));
+        }
+        block.data = data.constData();
+
+        // 校验: 随机参数点 (各轴在节点范围内均匀取值，对数轴按对数均匀)，在 z 半步处与精确解比较
+        double maxError = 0.0;
+        for (int sample = 0; sample < kValidationSamples; ++sample) {
+            double values[AxisCount];
+            for (int a = 0; a < AxisCount; ++a) {
+                const double lo = block.axisNodes[a][0];
+                const double hi = block.axisNodes[a][block.axisSize[a] - 1];
+                const double r = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                values[a] = block.axisLog[a] ? std::exp(std::log(lo) + r * (std::log(hi) - std::log(lo)))
+                                             : lo + r * (hi - lo);
+            }
+            const Query query = prepareBlock(block, values, 0.0, std::numeric_limits<double>::infinity());
+            if (!query.isValid()) continue;
+            const ModelParams p = nodeParams(values, bh.nf);
+            for (int iz = 1; iz + 2 < zCount; iz += std::max(1, zCount / 16)) {
+                const double z = std::pow(10.0, bh.zMinLog10 + (iz + 0.5) * bh.zStepLog10);
+                const double exact = kernel->reservoirReal(z, p);
+                const double approx = query(z);
+                if (exact > 0.0 && std::isfinite(exact)) maxError = std::max(maxError, std::abs(approx / exact - 1.0));
+            }
+        }
+        bh.validationError = maxError;
+
+        ok = file.seek(bh.axisOffset) && writeRaw(blockAxes[b].constData(), blockAxes[b].size() * qint64(sizeof(double)))
+             && file.seek(bh.dataOffset) && writeRaw(data.constData(), bh.valueCount * qint64(sizeof(float)));
+        if (!ok) return fail("写入类型曲线库失败: " + file.errorString());
+        qDebug() << "TypeCurveLibrary: 块" << b << "nf =" << bh.nf << "边界 =" << bh.boundary
+                 << "校验误差 =" << maxError;
+    }
+
+    // 回填块描述表 (含校验误差)，末尾补齐对齐字节
+    ok = file.seek(sizeof(FileHeader));
+    for (const BlockHeader& bh : headers) ok = ok && writeRaw(&bh, sizeof(bh));
+    if (ok && file.size() < offset) ok = file.resize(offset);
+    if (!ok) return fail("写入类型曲线库失败: " + file.errorString());
+    file.close();
+    return true;
+}
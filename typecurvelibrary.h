@@ -0,0 +1,114 @@
+/*
+ * 文件名: typecurvelibrary.h
+ * 文件作用: 无因次类型曲线库 (预计算、内存映射) 头文件
+ * 功能描述:
+ * 1. 离线生成: 对三种外边界 (无限大/封闭/定压) 与若干裂缝条数 nf，在无因次参数网格
+ *    (M12, LfD, rmD, omega1, omega2, lambda1, reD) 上制表不含井储的储层解 pf(z)。
+ *    井储与表皮只在 pf 上做代数修正，因此变井储模型与恒定井储模型共用一张表，cD、S 不占网格维度。
+ * 2. 文件格式带版本号与字节序标记，按固定布局写入，读取时整体内存映射 (QFile::map)，不复制数据。
+ * 3. 查询: ln(pf) 在各参数轴上做三次 Hermite 插值 (对数轴按对数坐标，端部区间取单侧斜率)，
+ *    z 方向为三次 Catmull-Rom 插值；参数或 z 超出制表范围时查询无效，由求解器回退到精确计算。
+ * 4. 生成时在随机网格单元内抽样，与精确解比较得到插值误差并写入文件，供调用方判断库的可信度。
+ */
+
+#ifndef TYPECURVELIBRARY_H
+#define TYPECURVELIBRARY_H
+
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include <functional>
+#include <limits>
+#include "modelsolver01-06.h"
+
+class TypeCurveLibrary
+{
+public:
+    // 参数轴 (reD 仅封闭/定压边界使用，无限大边界的 reD 轴只有一个节点)
+    enum Axis { AxisM12 = 0, AxisLfD, AxisRmD, AxisOmega1, AxisOmega2, AxisLambda1, AxisReD, AxisCount };
+
+    // 文件版本 (格式变化时递增，旧版本文件拒绝打开)
+    static const quint32 kVersion = 1;
+
+    // 参数轴节点 (升序)；logScale 为真时按对数坐标插值
+    struct AxisSpec {
+        QVector<double> nodes;
+        bool logScale = true;
+    };
+
+    // 生成设置
+    struct GenerationSpec {
+        AxisSpec axes[AxisCount];
+        QVector<int> nfValues;
+        double zMinLog10 = -8.0;    // z 网格范围 (预览的 Stehfest 取样覆盖 tD 约 4e-7 ~ 7e7)
+        double zMaxLog10 = 7.0;
+        int zPerDecade = 12;
+
+        // 覆盖 ModelManager 缺省参数附近常用范围的默认网格
+        static GenerationSpec defaultSpec();
+    };
+
+    // 一组参数上的插值查询: prepare 时完成参数方向的插值，得到 z 节点上的 ln(pf) 曲线，
+    // 之后按 z 取值只做 z 方向插值 (只读，可多线程调用)
+    class Query
+    {
+    public:
+        bool isValid() const { return m_logPf.size() >= 4; }
+        // pf(z)，z 超出 [zMin, zMax] 时返回 NaN
+        double operator()(double z) const;
+        double zMin() const;
+        double zMax() const;
+        double validationError() const { return m_validationError; }
+
+    private:
+        friend class TypeCurveLibrary;
+        QVector<double> m_logPf;            // z 节点 m_first ... m_first + size - 1 上的 ln(pf)
+        int m_first = 0;
+        double m_zMinLog10 = 0.0;
+        double m_zStepLog10 = 1.0;
+        double m_validationError = 0.0;
+    };
+
+    TypeCurveLibrary();
+    ~TypeCurveLibrary();
+
+    // 打开并内存映射库文件 (校验标记、版本、字节序与数据长度)
+    bool open(const QString& path, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+
+    // 为给定外边界与参数准备查询，只插值覆盖 [zLo, zHi] 所需的 z 节点 (与库的 z 范围取交集)；
+    // nf 未制表、参数超出网格范围或插值模板含无解节点时返回无效查询
+    Query prepare(ModelSolver01_06::BoundaryType boundary, const ModelParams& params,
+                  double zLo = 0.0, double zHi = std::numeric_limits<double>::infinity()) const;
+
+    // 离线生成库文件: progress(已完成, 总数) 在调用线程中按批回调
+    static bool generate(const QString& path, const GenerationSpec& spec, QString* error = nullptr,
+                         const std::function<void(int, int)>& progress = std::function<void(int, int)>());
+
+private:
+    // 一个外边界与 nf 组合的数据块 (指针指向映射内存，生成时指向内存中的数据)
+    struct Block {
+        int boundary = 0;
+        int nf = 0;
+        int zCount = 0;
+        double zMinLog10 = 0.0;
+        double zStepLog10 = 1.0;
+        const double* axisNodes[AxisCount] = {};
+        int axisSize[AxisCount] = {};
+        bool axisLog[AxisCount] = {};
+        const float* data = nullptr;
+        double validationError = 0.0;
+    };
+
+    const Block* findBlock(ModelSolver01_06::BoundaryType boundary, int nf) const;
+    static Query prepareBlock(const Block& block, const double values[AxisCount], double zLo, double zHi);
+
+    QFile m_file;
+    uchar* m_map;
+    qint64 m_size;
+    QVector<Block> m_blocks;
+};
+
+#endif // TYPECURVELIBRARY_H
@@ -0,0 +1,303 @@
+/*
+ * 文件名: typecurvematch.cpp
+ * 文件作用: 双对数典型曲线自动匹配 (拟合初值估计) 实现文件
+ * 功能描述:
+ * 1. 实测数据按对数时间分箱平均 (每箱权重相同，避免密集的晚期数据主导匹配)，参考曲线按双对数线性插值重采样。
+ * 2. 基 2 FFT 计算互相关，逐个时间平移求最优压力平移与加权均方残差，最优平移处做抛物线插值细化。
+ * 3. 缩放参数按加权最小范数分配对数改变量 (完全正交分解，参数不足两个时为最小二乘解)。
+ */
+
+#include "typecurvematch.h"
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+typedef std::complex<double> Complex;
+
+// 原位基 2 FFT (data.size() 须为 2 的幂)，inverse 为真时做逆变换 (不含 1/N)
+void fft(QVector<Complex>& data, bool inverse)
+{
+    const int n = data.size();
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(data[i], data[j]);
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        const double angle = 2.0 * M_PI / len * (inverse ? 1.0 : -1.0);
+        const Complex wlen(std::cos(angle), std::sin(angle));
+        for (int i = 0; i < n; i += len) {
+            Complex w(1.0, 0.0);
+            for (int k = 0; k < len / 2; ++k) {
+                const Complex u = data[i + k];
+                const Complex v = data[i + k + len / 2] * w;
+                data[i + k] = u + v;
+                data[i + k + len / 2] = u - v;
+                w *= wlen;
+            }
+        }
+    }
+}
+
+// 等距对数时间网格上的一条 (带权重的) 对数曲线
+struct LogSeries {
+    double x0 = 0.0;
+    QVector<double> weight;
+    QVector<double> value;
+};
+
+// 实测数据分箱: 箱中心 x0 + i*step，箱内对数值取平均，有数据的箱权重为 1
+LogSeries binObserved(const QVector<double>& t, const QVector<double>& y, double x0, int bins, double step)
+{
+    LogSeries s;
+    s.x0 = x0;
+    s.weight.fill(0.0, bins);
+    s.value.fill(0.0, bins);
+    QVector<int> count(bins, 0);
+    const int n = std::min(t.size(), y.size());
+    for (int i = 0; i < n; ++i) {
+        if (!(t[i] > 0.0) || !(y[i] > 0.0) || !std::isfinite(y[i])) continue;
+        const int b = int(std::lround((std::log(t[i]) - x0) / step));
+        if (b < 0 || b >= bins) continue;
+        s.value[b] += std::log(y[i]);
+        ++count[b];
+    }
+    for (int b = 0; b < bins; ++b) {
+        if (count[b] > 0) {
+            s.value[b] /= count[b];
+            s.weight[b] = 1.0;
+        }
+    }
+    return s;
+}
+
+// 参考曲线重采样: 网格点上按双对数线性插值，值非正的区间权重为 0
+LogSeries resampleReference(const QVector<double>& t, const QVector<double>& y, double x0, int points, double step)
+{
+    LogSeries s;
+    s.x0 = x0;
+    s.weight.fill(0.0, points);
+    s.value.fill(0.0, points);
+    int j = 0;
+    const int n = std::min(t.size(), y.size());
+    for (int k = 0; k < points; ++k) {
+        const double x = x0 + k * step;
+        while (j + 1 < n && std::log(t[j + 1]) < x) ++j;
+        if (j + 1 >= n) break;
+        if (!(t[j] > 0.0) || !(y[j] > 0.0) || !(y[j + 1] > 0.0)) continue;
+        const double xa = std::log(t[j]), xb = std::log(t[j + 1]);
+        if (x < xa || !(xb > xa)) continue;
+        const double u = (x - xa) / (xb - xa);
+        s.value[k] = (1.0 - u) * std::log(y[j]) + u * std::log(y[j + 1]);
+        s.weight[k] = 1.0;
+    }
+    return s;
+}
+
+// 互相关 c[l] = sum_i f[i] * g[i + l] (l 取 -(n-1) .. m-1，按 l mod size 存放)，fHat 为 f 的 FFT 共轭
+QVector<double> correlateSpectra(const QVector<Complex>& fHatConj, const QVector<Complex>& gHat)
+{
+    const int size = gHat.size();
+    QVector<Complex> product(size);
+    for (int k = 0; k < size; ++k) product[k] = fHatConj[k] * gHat[k];
+    fft(product, true);
+    QVector<double> result(size);
+    for (int k = 0; k < size; ++k) result[k] = product[k].real() / size;
+    return result;
+}
+
+QVector<Complex> spectrum(const QVector<double>& a, int size, bool conjugate)
+{
+    QVector<Complex> data(size, Complex(0.0, 0.0));
+    for (int i = 0; i < a.size(); ++i) data[i] = Complex(a[i], 0.0);
+    fft(data, false);
+    if (conjugate) {
+        for (Complex& c : data) c = std::conj(c);
+    }
+    return data;
+}
+}
+
+bool TypeCurveMatch::scalingExponents(const QString& name, double& pressureExponent, double& timeExponent)
+{
+    // dp 系数 1.842e-3*q*mu*B/(kf*h)，tD 系数 14.4*kf/(phi*mu*Ct*L^2)
+    if (name == "kf") { pressureExponent = -1.0; timeExponent = 1.0; }
+    else if (name == "h") { pressureExponent = -1.0; timeExponent = 0.0; }
+    else if (name == "L") { pressureExponent = 0.0; timeExponent = -2.0; }
+    else if (name == "phi" || name == "Ct") { pressureExponent = 0.0; timeExponent = -1.0; }
+    else if (name == "mu") { pressureExponent = 1.0; timeExponent = -1.0; }
+    else if (name == "B" || name == "q") { pressureExponent = 1.0; timeExponent = 0.0; }
+    else return false;
+    return true;
+}
+
+TypeCurveMatch::Shift TypeCurveMatch::correlate(const ModelCurveData& reference, const QVector<double>& obsTime,
+                                                const QVector<double>& obsDeltaP, const QVector<double>& obsDerivative,
+                                                double pressureWeight, int pointsPerDecade, double minOverlap)
+{
+    Shift result;
+    const QVector<double>& refTime = std::get<0>(reference);
+    if (refTime.size() < 2 || obsTime.isEmpty()) return result;
+
+    const double step = std::log(10.0) / std::max(1, pointsPerDecade);
+
+    // 1. 网格
+    double obsMin = std::numeric_limits<double>::infinity(), obsMax = -obsMin;
+    for (double t : obsTime) {
+        if (t > 0.0) {
+            obsMin = std::min(obsMin, std::log(t));
+            obsMax = std::max(obsMax, std::log(t));
+        }
+    }
+    if (!(obsMax >= obsMin) || !(refTime.first() > 0.0) || !(refTime.last() > refTime.first())) return result;
+    const int bins = int(std::floor((obsMax - obsMin) / step)) + 1;
+    const double refMin = std::log(refTime.first());
+    const int points = int(std::floor((std::log(refTime.last()) - refMin) / step)) + 1;
+
+    // 2. 两个通道 (压差、导数)，权重与拟合残差一致
+    const double channelWeight[2] = { pressureWeight * pressureWeight, (1.0 - pressureWeight) * (1.0 - pressureWeight) };
+    LogSeries obs[2] = { binObserved(obsTime, obsDeltaP, obsMin, bins, step),
+                         binObserved(obsTime, obsDerivative, obsMin, bins, step) };
+    LogSeries ref[2] = { resampleReference(refTime, std::get<1>(reference), refMin, points, step),
+                         resampleReference(refTime, std::get<2>(reference), refMin, points, step) };
+
+    // 对数值先减去均值 (压力平移吸收该常数)，减小相关和中的相消误差
+    double obsMean = 0.0, obsTotal = 0.0, refMean = 0.0, refTotal = 0.0;
+    for (int c = 0; c < 2; ++c) {
+        for (int i = 0; i < bins; ++i) { obsMean += obs[c].weight[i] * obs[c].value[i]; obsTotal += obs[c].weight[i]; }
+        for (int k = 0; k < points; ++k) { refMean += ref[c].weight[k] * ref[c].value[k]; refTotal += ref[c].weight[k]; }
+    }
+    if (!(obsTotal > 0.0) || !(refTotal > 0.0)) return result;
+    obsMean /= obsTotal;
+    refMean /= refTotal;
+
+    // 3. 互相关: A=Σwo*wr, B=Σwo*yo*wr, C=Σwo*wr*yr, D=Σwo*yo^2*wr, E=Σwo*wr*yr^2, F=Σwo*yo*wr*yr
+    int size = 1;
+    while (size < bins + points - 1) size <<= 1;
+    QVector<double> sumA(size, 0.0), sumBC(size, 0.0), sumDEF(size, 0.0);
+    double obsWeight = 0.0;
+    for (int c = 0; c < 2; ++c) {
+        if (!(channelWeight[c] > 0.0)) continue;
+        QVector<double> o0(bins), o1(bins), o2(bins), r0(points), r1(points), r2(points);
+        for (int i = 0; i < bins; ++i) {
+            const double y = obs[c].value[i] - obsMean;
+            o0[i] = obs[c].weight[i];
+            o1[i] = o0[i] * y;
+            o2[i] = o0[i] * y * y;
+            obsWeight += channelWeight[c] * o0[i];
+        }
+        for (int k = 0; k < points; ++k) {
+            const double y = ref[c].value[k] - refMean;
+            r0[k] = ref[c].weight[k];
+            r1[k] = r0[k] * y;
+            r2[k] = r0[k] * y * y;
+        }
+        const QVector<Complex> O0 = spectrum(o0, size, true), O1 = spectrum(o1, size, true), O2 = spectrum(o2, size, true);
+        const QVector<Complex> R0 = spectrum(r0, size, false), R1 = spectrum(r1, size, false), R2 = spectrum(r2, size, false);
+        const QVector<double> A = correlateSpectra(O0, R0);
+        const QVector<double> B = correlateSpectra(O1, R0);
+        const QVector<double> C = correlateSpectra(O0, R1);
+        const QVector<double> D = correlateSpectra(O2, R0);
+        const QVector<double> E = correlateSpectra(O0, R2);
+        const QVector<double> F = correlateSpectra(O1, R1);
+        for (int l = 0; l < size; ++l) {
+            sumA[l] += channelWeight[c] * A[l];
+            sumBC[l] += channelWeight[c] * (B[l] - C[l]);
+            sumDEF[l] += channelWeight[c] * (D[l] - 2.0 * F[l] + E[l]);
+        }
+    }
+    if (!(obsWeight > 0.0)) return result;
+
+    // 4. 逐个平移 l (参考点 k = i + l) 的最优压力平移与均方残差
+    auto evaluate = [&](int lag, double& misfit, double& shift, double& overlap) {
+        const int index = ((lag % size) + size) % size;
+        const double a = sumA[index];
+        overlap = a / obsWeight;
+        if (!(a > 0.0)) return false;
+        shift = sumBC[index] / a;
+        misfit = std::max(0.0, (sumDEF[index] - sumBC[index] * shift) / a);
+        return true;
+    };
+    int bestLag = 0;
+    double bestMisfit = std::numeric_limits<double>::infinity();
+    for (int lag = -(bins - 1); lag <= points - 1; ++lag) {
+        double misfit = 0.0, shift = 0.0, overlap = 0.0;
+        if (!evaluate(lag, misfit, shift, overlap) || overlap < minOverlap - 1e-9) continue;
+        if (misfit < bestMisfit) {
+            bestMisfit = misfit;
+            bestLag = lag;
+        }
+    }
+    if (!std::isfinite(bestMisfit)) return result;
+
+    // 5. 抛物线插值细化平移 (相邻平移不满足重叠要求时不细化)
+    double misfit = 0.0, shift = 0.0, overlap = 0.0;
+    evaluate(bestLag, misfit, shift, overlap);
+    double lag = bestLag;
+    double pressureShift = shift;
+    double m0 = 0.0, s0 = 0.0, v0 = 0.0, m1 = 0.0, s1 = 0.0, v1 = 0.0;
+    if (evaluate(bestLag - 1, m0, s0, v0) && v0 >= minOverlap - 1e-9 && evaluate(bestLag + 1, m1, s1, v1) && v1 >= minOverlap - 1e-9) {
+        const double curvature = m0 - 2.0 * misfit + m1;
+        if (curvature > 0.0) {
+            const double delta = std::max(-0.5, std::min(0.5, 0.5 * (m0 - m1) / curvature));
+            lag += delta;
+            pressureShift += (delta < 0.0) ? -delta * (s0 - shift) : delta * (s1 - shift);
+        }
+    }
+
+    // x_ref = x_obs - timeShift，参考点 k = i + lag
+    result.timeShift = (obsMin - refMin) - lag * step;
+    result.pressureShift = pressureShift + obsMean - refMean;
+    result.misfit = misfit;
+    result.overlap = overlap;
+    result.valid = true;
+    return result;
+}
+
+bool TypeCurveMatch::applyShift(QMap<QString, double>& params, const Shift& shift, const QStringList& freeNames)
+{
+    if (!shift.valid) return false;
+
+    // 可用的缩放参数及其改变的难易 (kf、L 为主要的匹配参数，其余多为已知的物性参数)
+    QStringList names;
+    QVector<double> pressureExp, timeExp, ease;
+    for (const QString& name : freeNames) {
+        double pe, te;
+        if (!scalingExponents(name, pe, te) || !(params.value(name) > 0.0)) continue;
+        names << name;
+        pressureExp << pe;
+        timeExp << te;
+        ease << ((name == "kf" || name == "L") ? 1.0 : 0.3);
+    }
+    if (names.isEmpty()) return false;
+
+    // ln(dp 系数) 增加 pressureShift，ln(tD 系数) 增加 -timeShift；在 ease 加权下取对数改变量最小的解
+    const int n = names.size();
+    Eigen::MatrixXd A(2, n);
+    for (int k = 0; k < n; ++k) {
+        A(0, k) = pressureExp[k] * ease[k];
+        A(1, k) = timeExp[k] * ease[k];
+    }
+    const Eigen::Vector2d rhs(shift.pressureShift, -shift.timeShift);
+    const Eigen::VectorXd u = A.completeOrthogonalDecomposition().solve(rhs);
+
+    for (int k = 0; k < n; ++k) {
+        const double factor = std::exp(u[k] * ease[k]);
+        params[names[k]] *= factor;
+        // 保持无因次形状: 导流比 kf/km 与 LfD = Lf/L
+        if (names[k] == "kf" && freeNames.contains("km") && params.contains("km")) params["km"] *= factor;
+        if (names[k] == "L" && freeNames.contains("Lf") && params.contains("Lf")) params["Lf"] *= factor;
+    }
+    if (params.contains("L") && params.contains("Lf") && params.value("L") > 1e-9)
+        params["LfD"] = params.value("Lf") / params.value("L");
+    return true;
+}
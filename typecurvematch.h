@@ -0,0 +1,47 @@
+/*
+ * 文件名: typecurvematch.h
+ * 文件作用: 双对数典型曲线自动匹配 (拟合初值估计) 头文件
+ * 功能描述:
+ * 1. 参考曲线与实测压差、导数在对数时间上重采样为等距网格，参考曲线在双对数图上整体平移:
+ *    ln(dp_obs) = ln(dp_ref(t / e^timeShift)) + pressureShift。
+ * 2. 对每个时间平移，最优压力平移与残差平方和都可由 6 个互相关序列 (权重、对数值、对数值平方的组合) 解析得到，
+ *    互相关用 FFT 一次算出全部平移，代价 O(n log n)。
+ * 3. 平移量换算为模型的缩放参数: dp 的系数 ∝ q*mu*B/(kf*h)，tD 的系数 ∝ kf/(phi*mu*Ct*L^2)，
+ *    在参与拟合的缩放参数中求对数改变量最小的解 (kf 优先)。
+ */
+
+#ifndef TYPECURVEMATCH_H
+#define TYPECURVEMATCH_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "modelsolver01-06.h"
+
+class TypeCurveMatch
+{
+public:
+    struct Shift {
+        bool valid = false;
+        double timeShift = 0.0;         // ln(t_obs / t_ref)
+        double pressureShift = 0.0;     // ln(dp_obs / dp_ref)
+        double misfit = 0.0;            // 重叠部分双对数残差的加权均方
+        double overlap = 0.0;           // 落在参考曲线范围内的观测权重比例
+    };
+
+    // reference 为参考曲线 <t, dp, t*dp/dt> (时间范围应比观测数据宽，决定可搜索的平移范围)；
+    // pressureWeight 为压差的权重 (导数权重为 1 - pressureWeight，与拟合残差一致)
+    static Shift correlate(const ModelCurveData& reference, const QVector<double>& obsTime,
+                           const QVector<double>& obsDeltaP, const QVector<double>& obsDerivative,
+                           double pressureWeight = 0.5, int pointsPerDecade = 20, double minOverlap = 0.8);
+
+    // 把平移量换算到 freeNames 中的缩放参数 (kf 改变时 km 同比例改变以保持导流比，L 改变时 Lf 同比例改变以保持 LfD，
+    // 仅当它们也在 freeNames 中)；没有可用的缩放参数时返回 false
+    static bool applyShift(QMap<QString, double>& params, const Shift& shift, const QStringList& freeNames);
+
+    // 缩放参数在压力系数与时间系数中的幂次 (非缩放参数返回 false)
+    static bool scalingExponents(const QString& name, double& pressureExponent, double& timeExponent);
+};
+
+#endif // TYPECURVEMATCH_H
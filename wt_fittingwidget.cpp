@@ -7,6 +7,25 @@
  * 3. 实现了数据的加载及展示。
  * 4. [新增] 实现了参数敏感性分析的多曲线绘制逻辑。
  * 5. [新增] 响应鼠标滚轮调节参数的实时重绘。
+ * 6. LM 的 Jacobian 由求解器的自动微分灵敏度一次得到 (差分仅作后备)；拟合残差按同样的固定阶数逐点反演，
+ *    不经主曲线插值与渐近段捷径，Jacobian 即残差的导数。
+ * 7. 滚轮调参时曲线由类型曲线库预览，停止滚动 kExactRedrawDelayMs 后按精确解重绘并计算误差。
+ * 8. 拟合线程的精度设置随每次调用传入 (SolverOptions)，不修改 ModelManager 的全局设置，各拟合页可同时拟合。
+ * 9. 反褶积: 选择压力与产量数据后反求定产响应，结果 (参考产量下的压差与导数) 直接作为观测数据。
+ * 10. 自动初值: 参考曲线在双对数图上与观测数据做 FFT 互相关，平移量换算为 kf、L 等缩放参数 (cD 在一组候选值中挑选)；
+ *     参考曲线由类型曲线库插值；可在 LM 开始前自动执行，只在 (精确计算的) 残差下降时采用；
+ *     单独点击“自动初值”时在后台线程计算，期间按钮不可用。
+ * 11. 差分 Jacobian (灵敏度不可用时的后备) 的 2*nParams 条扰动曲线在独立线程池中并行计算，按下标写回，结果与调度无关。
+ * 12. LM 迭代由 LevenbergMarquardt 完成 (Broyden 秩一更新、信赖域、QR 求解阻尼子问题)，
+ *     这里只负责对数/线性参数化、参数范围、Jacobian (列存储的 Eigen 矩阵) 与进度/停止回调。
+ * 13. 全局拟合: 参数表当前值加上拉丁超立方 (对数空间) 取样的起点由 MultiStartFit 并发拟合，
+ *     被当前最优支配的起点提前取消；结束后按误差列出不同的解，可选择其中之一写回参数表。
+ * 14. 差分进化: 无需导数的 DifferentialEvolution 在参数范围内搜索，每代成批并行求值；
+ *     cD、S 与纯缩放参数划为廉价块，其变体复用求解器的储层解与无因次主曲线缓存 (种群求值按全局缓存设置)；
+ *     结束后用 LM 精修。
+ * 15. 变产量拟合: 选择压力与产量数据并给定初始压力后，观测数据为 pi - p(t) 及其 Bourdet 导数；
+ *     残差、拟合过程与界面上的理论曲线均按产量历史叠加单位产量响应 (ModelManager::calculateVariableRateCurve)，
+ *     Jacobian 用差分 (灵敏度为定产曲线的)，自动初值 (定产双对数互相关) 不可用。
  */
 
 #include "wt_fittingwidget.h"
@@ -16,11 +35,22 @@
 #include "fittingdatadialog.h"
 #include "pressurederivativecalculator.h"
 #include "pressurederivativecalculator1.h"
+#include "plottingdialog2.h"
+#include "deconvolution.h"
+#include "typecurvematch.h"
+#include "levenbergmarquardt.h"
+#include "multistartfit.h"
+#include "differentialevolution.h"
+#include "computesupport.h"
 
 #include <QtConcurrent>
+#include <QThread>
+#include <QThreadPool>
 #include <QMessageBox>
+#include <QApplication>
 #include <QDebug>
 #include <cmath>
+#include <limits>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -31,12 +61,50 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QComboBox>
+#include <QInputDialog>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
 #include <QBuffer>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QTableWidget>
 #include <Eigen/Dense>
 
+// 拟合时 Stehfest 的固定阶数 (残差与灵敏度同阶反演，Jacobian 才是残差的导数)
+static const int kFitStehfestOrder = 12;
+// 滚轮调参停止后到精确重绘的延迟 (毫秒)
+static const int kExactRedrawDelayMs = 300;
+
+// 自动初值: 参考曲线在观测时间范围两侧各延伸的对数周期数 (即可搜索的时间平移范围)，及每个对数周期的点数
+static const double kAutoMatchDecades = 4.0;
+static const int kAutoMatchPointsPerDecade = 20;
+// LM 的最大迭代次数与提前结束的残差均方
+static const int kFitMaxIterations = 50;
+static const double kFitTargetMeanSquare = 3e-3;
+// 全局拟合: 下限不大于 0 的对数参数在当前值以下取样的对数周期数，及拉丁超立方的随机种子 (固定，便于复现)
+static const double kGlobalFitDecadesBelow = 3.0;
+static const unsigned kGlobalFitSeed = 1;
+// 差分进化的最大代数
+static const int kEvolutionMaxGenerations = 200;
+// 变产量拟合: 观测压差 Bourdet 导数的 L-Spacing (与观测数据对话框的默认值一致)
+static const double kRateHistoryLSpacing = 0.1;
+
+// 读取数据表中的两列数值 (跳过非数值行)
+static void readColumns(QStandardItemModel* model, int xCol, int yCol, QVector<double>& x, QVector<double>& y)
+{
+    if (!model) return;
+    for (int i = 0; i < model->rowCount(); ++i) {
+        QStandardItem* itemX = model->item(i, xCol);
+        QStandardItem* itemY = model->item(i, yCol);
+        if (!itemX || !itemY) continue;
+        bool okX, okY;
+        double vx = itemX->text().toDouble(&okX);
+        double vy = itemY->text().toDouble(&okY);
+        if (okX && okY) { x.append(vx); y.append(vy); }
+    }
+}
+
 // 构造函数
 FittingWidget::FittingWidget(QWidget *parent) :
     QWidget(parent),
@@ -46,7 +114,11 @@ FittingWidget::FittingWidget(QWidget *parent) :
     m_plot(nullptr),
     m_plotTitle(nullptr),
     m_currentModelType(ModelManager::Model_1),
-    m_isFitting(false)
+    m_isFitting(false),
+    m_stopRequested(false),
+    m_autoMatchBeforeFit(true),
+    m_fitMethod(FitLevenbergMarquardt),
+    m_globalStartCount(16)
 {
     ui->setupUi(this);
 
@@ -66,8 +138,14 @@ FittingWidget::FittingWidget(QWidget *parent) :
 
     m_paramChart = new FittingParameterChart(ui->tableParams, this);
 
-    // [新增] 连接参数图表的滚轮调节信号，实现实时刷新
-    connect(m_paramChart, &FittingParameterChart::parameterChangedByWheel, this, &FittingWidget::updateModelCurve);
+    // [新增] 连接参数图表的滚轮调节信号，实现实时刷新 (预览曲线，停止滚动后精确重绘)
+    m_exactRedrawTimer.setSingleShot(true);
+    m_exactRedrawTimer.setInterval(kExactRedrawDelayMs);
+    connect(&m_exactRedrawTimer, &QTimer::timeout, this, [this]() { updateModelCurve(); });
+    connect(m_paramChart, &FittingParameterChart::parameterChangedByWheel, this, [this]() {
+        updateModelCurve(true);
+        m_exactRedrawTimer.start();
+    });
 
     setupPlot();
 
@@ -78,6 +156,13 @@ FittingWidget::FittingWidget(QWidget *parent) :
     connect(this, &FittingWidget::sigIterationUpdated, this, &FittingWidget::onIterationUpdate, Qt::QueuedConnection);
     connect(this, &FittingWidget::sigProgress, ui->progressBar, &QProgressBar::setValue);
     connect(&m_watcher, &QFutureWatcher<void>::finished, this, &FittingWidget::onFitFinished);
+    connect(&m_autoMatchWatcher, &QFutureWatcher<QList<FitParameter>>::finished, this, &FittingWidget::onAutoMatchFinished);
+
+    // 起点数只用于多起点全局拟合
+    ui->spinStartCount->setEnabled(ui->comboFitMethod->currentIndex() == FitMultiStart);
+    connect(ui->comboFitMethod, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        ui->spinStartCount->setEnabled(index == FitMultiStart);
+    });
 
     connect(ui->sliderWeight, &QSlider::valueChanged, this, &FittingWidget::onSliderWeightChanged);
 
@@ -245,10 +330,92 @@ void FittingWidget::on_btnLoadData_clicked() {
     QMessageBox::information(this, "成功", "观测数据已成功加载。");
 }
 
+// 反褶积: 压力与产量的文件/列选择沿用压力产量图的对话框 (产量为阶梯图时 X 列为各段时长，否则为起始时刻)
+void FittingWidget::on_btnDeconvolution_clicked() {
+    if (m_dataMap.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可用的数据文件！");
+        return;
+    }
+    PlottingDialog2 dlg(m_dataMap, this);
+    dlg.setWindowTitle("反褶积数据选择");
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    QVector<double> pressTime, pressure, prodX, rates;
+    readColumns(m_dataMap.value(dlg.getPressFileName()), dlg.getPressXCol(), dlg.getPressYCol(), pressTime, pressure);
+    readColumns(m_dataMap.value(dlg.getProdFileName()), dlg.getProdXCol(), dlg.getProdYCol(), prodX, rates);
+    if (pressTime.isEmpty() || rates.isEmpty()) {
+        QMessageBox::warning(this, "警告", "未能提取到有效的压力或产量数据。");
+        return;
+    }
+    QVector<double> changeTimes = (dlg.getProdGraphType() == 0) ? Deconvolution::changeTimesFromDurations(prodX) : prodX;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    Deconvolution::Result result = Deconvolution::deconvolve(pressTime, pressure, changeTimes, rates);
+    QApplication::restoreOverrideCursor();
+
+    if (!result.ok) {
+        QMessageBox::warning(this, "反褶积失败", result.message);
+        return;
+    }
+    setObservedData(result.time, result.deltaP, result.derivative);
+    QMessageBox::information(this, "反褶积完成",
+                             QString("迭代 %1 次，初始压力 %2，压力残差均方根 %3\n观测数据为产量 %4 下的定产压差与导数。")
+                                 .arg(result.iterations)
+                                 .arg(result.initialPressure, 0, 'f', 4)
+                                 .arg(result.rmsMisfit, 0, 'g', 4)
+                                 .arg(result.referenceRate, 0, 'g', 6));
+}
+
+// 变产量拟合: 数据选择同反褶积；初始压力默认取第一次产量变化前 (或第一个) 的压力测点
+void FittingWidget::on_btnRateHistory_clicked() {
+    if (m_isFitting || m_autoMatchWatcher.isRunning()) return;
+    if (m_dataMap.isEmpty()) {
+        QMessageBox::warning(this, "警告", "没有可用的数据文件！");
+        return;
+    }
+    PlottingDialog2 dlg(m_dataMap, this);
+    dlg.setWindowTitle("变产量拟合数据选择");
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    QVector<double> pressTime, pressure, prodX, rates;
+    readColumns(m_dataMap.value(dlg.getPressFileName()), dlg.getPressXCol(), dlg.getPressYCol(), pressTime, pressure);
+    readColumns(m_dataMap.value(dlg.getProdFileName()), dlg.getProdXCol(), dlg.getProdYCol(), prodX, rates);
+    if (pressTime.isEmpty() || rates.isEmpty()) {
+        QMessageBox::warning(this, "警告", "未能提取到有效的压力或产量数据。");
+        return;
+    }
+    QVector<double> changeTimes = (dlg.getProdGraphType() == 0) ? Deconvolution::changeTimesFromDurations(prodX) : prodX;
+    int n = qMin(changeTimes.size(), rates.size());
+    changeTimes.resize(n);
+    rates.resize(n);
+    for (int j = 1; j < n; ++j) {
+        if (!(changeTimes[j] > changeTimes[j-1])) {
+            QMessageBox::warning(this, "警告", "产量变化时刻须严格递增。");
+            return;
+        }
+    }
+
+    double defaultPi = pressure.first();
+    for (int i = 0; i < pressTime.size() && pressTime[i] <= changeTimes.first(); ++i) defaultPi = pressure[i];
+    bool ok = false;
+    double initialPressure = QInputDialog::getDouble(this, "变产量拟合", "初始地层压力:", defaultPi, -1e12, 1e12, 4, &ok);
+    if (!ok) return;
+
+    QVector<double> deltaP;
+    for (double p : pressure) deltaP.append(initialPressure - p);
+    QVector<double> deriv = PressureDerivativeCalculator::calculateBourdetDerivative(pressTime, deltaP, kRateHistoryLSpacing);
+
+    setObservedData(pressTime, deltaP, deriv);
+    setRateHistory(changeTimes, rates);
+    updateModelCurve();
+}
+
+// 观测数据本身不带产量历史: 由 on_btnRateHistory_clicked / loadFittingState 在其后调用 setRateHistory
 void FittingWidget::setObservedData(const QVector<double>& t, const QVector<double>& deltaP, const QVector<double>& d) {
     m_obsTime = t;
     m_obsDeltaP = deltaP;
     m_obsDerivative = d;
+    setRateHistory(QVector<double>(), QVector<double>());
 
     QVector<double> vt, vp, vd;
     for(int i=0; i<t.size(); ++i) {
@@ -269,6 +436,28 @@ void FittingWidget::setObservedData(const QVector<double>& t, const QVector<doub
     m_plot->replot();
 }
 
+void FittingWidget::setRateHistory(const QVector<double>& changeTimes, const QVector<double>& rates) {
+    m_rateChangeTimes = changeTimes;
+    m_rateValues = rates;
+    if (changeTimes.isEmpty() || changeTimes.size() != rates.size()) {
+        m_rateHistory.reset();
+    } else {
+        m_rateHistory.reset(new RateSuperposition(changeTimes, rates));
+    }
+    ui->btnAutoMatch->setEnabled(!m_rateHistory && !m_autoMatchWatcher.isRunning());
+    ui->chkAutoMatch->setEnabled(!m_rateHistory);
+}
+
+ModelCurveData FittingWidget::modelCurve(ModelManager::ModelType modelType, const QMap<QString, double>& params, const QVector<double>& t,
+                                         const SolverOptions& options, bool preview) {
+    // 拟合线程与界面线程都会调用，先取一份引用计数的副本
+    QSharedPointer<const RateSuperposition> history = m_rateHistory;
+    if (history)
+        return m_modelManager->calculateVariableRateCurve(modelType, params, t.isEmpty() ? m_obsTime : t, *history, options);
+    return preview ? m_modelManager->calculatePreviewCurve(modelType, params, t, options)
+                   : m_modelManager->calculateTheoreticalCurve(modelType, params, t, options);
+}
+
 void FittingWidget::onSliderWeightChanged(int value)
 {
     double wPressure = value / 100.0;
@@ -289,7 +478,7 @@ void FittingWidget::on_btnSelectParams_clicked()
 }
 
 void FittingWidget::on_btnRunFit_clicked() {
-    if(m_isFitting) return;
+    if(m_isFitting || m_autoMatchWatcher.isRunning()) return;
     if(m_obsTime.isEmpty()) {
         QMessageBox::warning(this,"错误","请先加载观测数据。");
         return;
@@ -298,6 +487,10 @@ void FittingWidget::on_btnRunFit_clicked() {
     m_paramChart->updateParamsFromTable();
     m_isFitting = true;
     m_stopRequested = false;
+    m_autoMatchBeforeFit = ui->chkAutoMatch->isChecked() && !m_rateHistory;
+    m_fitMethod = ui->comboFitMethod->currentIndex();
+    m_globalStartCount = ui->spinStartCount->value();
+    m_globalSolutions.clear();
     ui->btnRunFit->setEnabled(false);
 
     ModelManager::ModelType modelType = m_currentModelType;
@@ -323,6 +516,39 @@ void FittingWidget::on_btnResetParams_clicked() {
     updateModelCurve();
 }
 
+// 参考曲线扫描与精修计算量较大，与拟合一样在后台线程进行，结束后由 onAutoMatchFinished 写回参数表
+void FittingWidget::on_btnAutoMatch_clicked() {
+    if(!m_modelManager || m_isFitting || m_autoMatchWatcher.isRunning() || m_rateHistory) return;
+    if(m_obsTime.isEmpty()) {
+        QMessageBox::warning(this,"错误","请先加载观测数据。");
+        return;
+    }
+
+    m_paramChart->updateParamsFromTable();
+    QList<FitParameter> params = m_paramChart->getParameters();
+    double w = ui->sliderWeight->value() / 100.0;
+    ModelManager::ModelType modelType = m_currentModelType;
+    SolverOptions options = fitSolverOptions();
+    ui->btnAutoMatch->setEnabled(false);
+
+    m_autoMatchWatcher.setFuture(QtConcurrent::run([this, modelType, params, w, options]() {
+        QList<FitParameter> matched = params;
+        if(!autoMatchParameters(modelType, matched, w, options)) matched.clear();
+        return matched;
+    }));
+}
+
+void FittingWidget::onAutoMatchFinished() {
+    ui->btnAutoMatch->setEnabled(true);
+    QList<FitParameter> params = m_autoMatchWatcher.result();
+    if(params.isEmpty()) {
+        QMessageBox::information(this, "自动初值", "未找到比当前参数更好的初值 (请确认 kf、L 等缩放参数已勾选参与拟合)。");
+        return;
+    }
+    m_paramChart->setParameters(params);
+    updateModelCurve();
+}
+
 void FittingWidget::on_btn_modelSelect_clicked() {
     ModelSelect dlg(this);
     if (dlg.exec() == QDialog::Accepted) {
@@ -464,130 +690,355 @@ void FittingWidget::onExportCurveData() {
 }
 
 void FittingWidget::runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight) {
-    runLevenbergMarquardtOptimization(modelType, fitParams, weight);
+    if(m_fitMethod == FitMultiStart) runGlobalOptimization(modelType, fitParams, weight);
+    else if(m_fitMethod == FitDifferentialEvolution) runEvolutionOptimization(modelType, fitParams, weight);
+    else runLevenbergMarquardtOptimization(modelType, fitParams, weight);
 }
 
-// Levenberg-Marquardt
-void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
-    if(m_modelManager) m_modelManager->setHighPrecision(false);
+// 拟合期间残差与 Jacobian 走同一条计算路径: 逐点直接反演，不用主曲线插值与渐近段捷径，阶数固定
+// (Stehfest 取 kFitStehfestOrder，其余反演算法降阶)，残差是参数的光滑函数，灵敏度给出的 Jacobian 正是其导数；
+// 选项只用于本次拟合的计算，界面刷新与其他拟合页仍使用全局设置
+SolverOptions FittingWidget::fitSolverOptions() const {
+    SolverOptions options;
+    if(m_modelManager) options = m_modelManager->solverOptions();
+    options.highPrecision = false;
+    options.inversionTolerance = 0.0;
+    options.asymptoticTolerance = 0.0;
+    options.cacheEnabled = false;
+    if(options.inversionMethod == LaplaceInversion::Stehfest && options.inversionOrder <= 0)
+        options.inversionOrder = kFitStehfestOrder;
+    return options;
+}
+
+// 优化变量 x 中对数参数为 log10(值)，其余为原值 (参数化在开始时确定)；参数范围按同样方式换算
+FittingWidget::FitVariables FittingWidget::makeFitVariables(const QList<FitParameter>& params) {
+    FitVariables vars;
+    for(const auto& p : params) vars.base.insert(p.name, p.value);
+    if(vars.base.contains("L") && vars.base.contains("Lf") && vars.base["L"] > 1e-9)
+        vars.base["LfD"] = vars.base["Lf"] / vars.base["L"];
+
+    QList<FitParameter> fitted;
+    for(const auto& p : params) {
+        if(p.isFit) fitted.append(p);
+    }
+    int nParams = fitted.size();
+    vars.logScale.resize(nParams);
+    vars.x0.resize(nParams);
+    vars.lower.resize(nParams);
+    vars.upper.resize(nParams);
+    for(int j=0; j<nParams; ++j) {
+        const FitParameter& p = fitted[j];
+        double val = vars.base[p.name];
+        vars.names << p.name;
+        vars.logScale[j] = (val > 1e-12 && p.name != "S" && p.name != "nf");
+        if(vars.logScale[j]) {
+            vars.x0[j] = log10(val);
+            vars.lower[j] = (p.min > 0) ? log10(p.min) : -std::numeric_limits<double>::infinity();
+            vars.upper[j] = (p.max > 0) ? log10(p.max) : vars.x0[j];
+        } else {
+            vars.x0[j] = val;
+            vars.lower[j] = p.min;
+            vars.upper[j] = p.max;
+        }
+    }
+    return vars;
+}
+
+QMap<QString, double> FittingWidget::FitVariables::toParamMap(const Eigen::VectorXd& x) const {
+    QMap<QString, double> map = base;
+    for(int j=0; j<names.size(); ++j) map[names[j]] = logScale[j] ? pow(10.0, x[j]) : x[j];
+    if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9)
+        map["LfD"] = map["Lf"] / map["L"];
+    return map;
+}
 
-    QVector<int> fitIndices;
-    for(int i=0; i<params.size(); ++i) {
-        if(params[i].isFit) fitIndices.append(i);
+// 全局搜索的取样范围: 参数范围换算到优化变量，下限不大于 0 的对数参数取当前值以下 kGlobalFitDecadesBelow 个对数周期
+void FittingWidget::samplingBounds(const FitVariables& vars, Eigen::VectorXd& lower, Eigen::VectorXd& upper) {
+    lower = vars.lower;
+    upper = vars.upper;
+    for(int j=0; j<lower.size(); ++j) {
+        if(!std::isfinite(lower[j])) lower[j] = vars.x0[j] - kGlobalFitDecadesBelow;
     }
-    int nParams = fitIndices.size();
+}
+
+// 残差与 Jacobian (可被多个线程同时调用)；进度与停止回调由调用方设置
+LevenbergMarquardt::Problem FittingWidget::makeFitProblem(ModelManager::ModelType modelType, const FitVariables& vars, double weight, const SolverOptions& options) {
+    LevenbergMarquardt::Problem problem;
+    problem.lower = vars.lower;
+    problem.upper = vars.upper;
+    problem.residuals = [this, vars, modelType, weight, options](const Eigen::VectorXd& x, Eigen::VectorXd& r) {
+        QVector<double> res = calculateResiduals(vars.toParamMap(x), modelType, weight, options);
+        r = Eigen::Map<const Eigen::VectorXd>(res.constData(), res.size());
+        return !res.isEmpty();
+    };
+    problem.jacobian = [this, vars, modelType, weight, options](const Eigen::VectorXd& x, const Eigen::VectorXd& r, Eigen::MatrixXd& J,
+                                                                bool& approximate) {
+        J = computeJacobian(vars.toParamMap(x), int(r.size()), vars.names, vars.logScale, modelType, weight, options, &approximate);
+        return true;
+    };
+    return problem;
+}
+
+// Levenberg-Marquardt: 迭代本身由 LevenbergMarquardt 完成，这里只负责参数映射、进度与停止
+void FittingWidget::runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
+    SolverOptions fitOptions = fitSolverOptions();
+
+    if(m_autoMatchBeforeFit) autoMatchParameters(modelType, params, weight, fitOptions);
 
-    if(nParams == 0) {
+    FitVariables vars = makeFitVariables(params);
+    if(vars.names.isEmpty()) {
         QMetaObject::invokeMethod(this, "onFitFinished");
         return;
     }
+    QMap<QString, double> currentParamMap = vars.base;
+
+    LevenbergMarquardt::Settings settings;
+    settings.maxIterations = kFitMaxIterations;
+    settings.targetMeanSquare = kFitTargetMeanSquare;
+
+    LevenbergMarquardt::Problem problem = makeFitProblem(modelType, vars, weight, fitOptions);
+    problem.iterationStarted = [&](int iter) {
+        if(m_stopRequested) return false;
+        emit sigProgress(iter * 100 / kFitMaxIterations);
+        return true;
+    };
+    problem.stepAccepted = [&](const Eigen::VectorXd& x, double meanSquare) {
+        QMap<QString, double> map = vars.toParamMap(x);
+        ModelCurveData iterCurve = modelCurve(modelType, map, QVector<double>(), fitOptions);
+        emit sigIterationUpdated(meanSquare, map, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
+    };
+
+    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight, fitOptions);
+    double currentSSE = calculateSumSquaredError(residuals);
+    ModelCurveData curve = modelCurve(modelType, currentParamMap, QVector<double>(), fitOptions);
+    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+
+    LevenbergMarquardt::Result result = LevenbergMarquardt::minimize(problem, vars.x0, settings);
+
+    if(result.residualCount > 0) {
+        currentParamMap = vars.toParamMap(result.x);
+        currentSSE = result.sse;
+    }
 
-    double lambda = 0.01;
-    int maxIter = 50;
-    double currentSSE = 1e15;
+    ModelCurveData finalCurve = modelCurve(modelType, currentParamMap, QVector<double>(), m_modelManager->solverOptions());
+    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
 
-    QMap<QString, double> currentParamMap;
-    for(const auto& p : params) currentParamMap.insert(p.name, p.value);
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+// 全局拟合: 第一个起点为参数表当前值 (勾选自动初值时先自动匹配)，其余为参数范围内的拉丁超立方样本；
+// 各起点并发运行，进度为已结束的起点比例，最优解写回参数表，全部不同的解保存在 m_globalSolutions
+void FittingWidget::runGlobalOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
+    SolverOptions fitOptions = fitSolverOptions();
 
-    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight);
-    currentSSE = calculateSumSquaredError(residuals);
+    if(m_autoMatchBeforeFit) autoMatchParameters(modelType, params, weight, fitOptions);
 
-    ModelCurveData curve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+    FitVariables vars = makeFitVariables(params);
+    if(vars.names.isEmpty()) {
+        QMetaObject::invokeMethod(this, "onFitFinished");
+        return;
+    }
 
-    for(int iter = 0; iter < maxIter; ++iter) {
-        if(m_stopRequested) break;
-        if (!residuals.isEmpty() && (currentSSE / residuals.size()) < 3e-3) break;
+    Eigen::VectorXd sampleLower, sampleUpper;
+    samplingBounds(vars, sampleLower, sampleUpper);
+    QVector<Eigen::VectorXd> starts;
+    starts << vars.x0;
+    starts << MultiStartFit::latinHypercube(sampleLower, sampleUpper, qMax(1, m_globalStartCount - 1), kGlobalFitSeed);
+
+    // 起点已占满线程时每条曲线内部的反演取样不再并行，避免线程过量
+    int concurrent = qMin(int(starts.size()), QThread::idealThreadCount());
+    if(fitOptions.threadCount == 0)
+        fitOptions.threadCount = qMax(1, QThread::idealThreadCount() / qMax(1, concurrent));
+
+    MultiStartFit::Settings settings;
+    settings.lm.maxIterations = kFitMaxIterations;
+    settings.lm.targetMeanSquare = kFitTargetMeanSquare;
+
+    QMap<QString, double> currentParamMap = vars.base;
+    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight, fitOptions);
+    double currentMSE = calculateSumSquaredError(residuals) / residuals.size();
+
+    QVector<MultiStartFit::Solution> solutions = MultiStartFit::run(
+        makeFitProblem(modelType, vars, weight, fitOptions), starts, sampleLower, sampleUpper, settings,
+        [this]() { return bool(m_stopRequested); },
+        [this](int finished, int total) { emit sigProgress(finished * 100 / total); });
+
+    QVector<GlobalFitSolution> ranked;
+    for(const auto& sol : solutions) {
+        GlobalFitSolution g;
+        g.params = vars.toParamMap(sol.x);
+        g.meanSquare = sol.meanSquare;
+        g.hits = sol.hits;
+        ranked.append(g);
+    }
+    if(!ranked.isEmpty() && ranked.first().meanSquare < currentMSE) {
+        currentParamMap = ranked.first().params;
+        currentMSE = ranked.first().meanSquare;
+    }
+    m_globalSolutions = ranked;
 
-        emit sigProgress(iter * 100 / maxIter);
+    ModelCurveData finalCurve = modelCurve(modelType, currentParamMap, QVector<double>(), m_modelManager->solverOptions());
+    emit sigIterationUpdated(currentMSE, currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
 
-        QVector<QVector<double>> J = computeJacobian(currentParamMap, residuals, fitIndices, modelType, params, weight);
-        int nRes = residuals.size();
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
 
-        QVector<QVector<double>> H(nParams, QVector<double>(nParams, 0.0));
-        QVector<double> g(nParams, 0.0);
+// 差分进化: 种群包含参数表当前值 (勾选自动初值时先自动匹配)，其余在取样范围内按拉丁超立方初始化；
+// 目标函数为残差均方，每代结束时更新进度并在最优解改善时刷新曲线；未被停止时最后用 LM 从最优解精修
+void FittingWidget::runEvolutionOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight) {
+    SolverOptions fitOptions = fitSolverOptions();
 
-        for(int k=0; k<nRes; ++k) {
-            for(int i=0; i<nParams; ++i) {
-                g[i] += J[k][i] * residuals[k];
-                for(int j=0; j<=i; ++j) {
-                    H[i][j] += J[k][i] * J[k][j];
-                }
-            }
-        }
-        for(int i=0; i<nParams; ++i) {
-            for(int j=i+1; j<nParams; ++j) {
-                H[i][j] = H[j][i];
-            }
+    if(m_autoMatchBeforeFit) autoMatchParameters(modelType, params, weight, fitOptions);
+
+    FitVariables vars = makeFitVariables(params);
+    if(vars.names.isEmpty()) {
+        QMetaObject::invokeMethod(this, "onFitFinished");
+        return;
+    }
+
+    // 种群已占满线程，每条曲线内部的反演取样不再并行
+    if(fitOptions.threadCount == 0) fitOptions.threadCount = 1;
+    // 种群求值不用导数，沿用全局的缓存设置 (廉价变体依赖储层解与主曲线缓存)；LM 精修仍用 fitOptions
+    SolverOptions searchOptions = fitOptions;
+    searchOptions.cacheEnabled = m_modelManager->solverOptions().cacheEnabled;
+
+    DifferentialEvolution::Problem problem;
+    samplingBounds(vars, problem.lower, problem.upper);
+    // 廉价块: cD、S 只改变井储表皮修正 (储层解 pf(z) 可复用)；纯缩放参数只改变 tD 与压差的换算 (无因次主曲线可复用)
+    static const QStringList storageNames = {"cD", "S"};
+    static const QStringList scalingNames = {"gamaD", "h", "phi", "Ct", "mu", "B", "q"};
+    problem.block = QVector<int>(vars.names.size(), 0);
+    for(int j=0; j<vars.names.size(); ++j) {
+        if(storageNames.contains(vars.names[j])) problem.block[j] = 1;
+        else if(scalingNames.contains(vars.names[j])) problem.block[j] = 2;
+    }
+    problem.cost = [this, vars, modelType, weight, searchOptions](const Eigen::VectorXd& x) {
+        QVector<double> res = calculateResiduals(vars.toParamMap(x), modelType, weight, searchOptions);
+        if(res.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+        return calculateSumSquaredError(res) / res.size();
+    };
+
+    DifferentialEvolution::Settings settings;
+    settings.maxGenerations = kEvolutionMaxGenerations;
+    settings.targetCost = kFitTargetMeanSquare;
+    settings.seed = kGlobalFitSeed;
+
+    QMap<QString, double> currentParamMap = vars.base;
+    QVector<double> residuals = calculateResiduals(currentParamMap, modelType, weight, fitOptions);
+    double currentMSE = calculateSumSquaredError(residuals) / residuals.size();
+
+    double reportedMSE = currentMSE;
+    DifferentialEvolution::Result result = DifferentialEvolution::minimize(problem, QVector<Eigen::VectorXd>() << vars.x0, settings,
+        [&](int generation, const Eigen::VectorXd& best, double bestCost) {
+            emit sigProgress(generation * 100 / kEvolutionMaxGenerations);
+            if(!(bestCost < reportedMSE)) return;
+            reportedMSE = bestCost;
+            QMap<QString, double> map = vars.toParamMap(best);
+            ModelCurveData curve = modelCurve(modelType, map, QVector<double>(), fitOptions);
+            emit sigIterationUpdated(bestCost, map, std::get<0>(curve), std::get<1>(curve), std::get<2>(curve));
+        },
+        [this]() { return bool(m_stopRequested); });
+
+    // 种群的误差带有缓存插值误差，与当前值比较前按拟合选项重新计算
+    if(result.status != DifferentialEvolution::Failed) {
+        QMap<QString, double> bestMap = vars.toParamMap(result.x);
+        QVector<double> bestResiduals = calculateResiduals(bestMap, modelType, weight, fitOptions);
+        double bestMSE = calculateSumSquaredError(bestResiduals) / bestResiduals.size();
+        if(bestMSE < currentMSE) {
+            currentParamMap = bestMap;
+            currentMSE = bestMSE;
         }
+    }
 
-        bool stepAccepted = false;
-        for(int tryIter=0; tryIter<5; ++tryIter) {
-            QVector<QVector<double>> H_lm = H;
-            for(int i=0; i<nParams; ++i) {
-                H_lm[i][i] += lambda * (1.0 + std::abs(H[i][i]));
-            }
+    // LM 精修 (差分进化接近最优解后收敛慢)
+    if(!m_stopRequested && result.status != DifferentialEvolution::Failed) {
+        LevenbergMarquardt::Settings lmSettings;
+        lmSettings.maxIterations = kFitMaxIterations;
+        lmSettings.targetMeanSquare = kFitTargetMeanSquare;
+        LevenbergMarquardt::Problem lmProblem = makeFitProblem(modelType, vars, weight, fitOptions);
+        lmProblem.iterationStarted = [this](int) { return !m_stopRequested; };
+        LevenbergMarquardt::Result polished = LevenbergMarquardt::minimize(lmProblem, result.x, lmSettings);
+        if(polished.residualCount > 0 && polished.sse / polished.residualCount < currentMSE) {
+            currentParamMap = vars.toParamMap(polished.x);
+            currentMSE = polished.sse / polished.residualCount;
+        }
+    }
 
-            QVector<double> negG(nParams);
-            for(int i=0;i<nParams;++i) negG[i] = -g[i];
+    ModelCurveData finalCurve = modelCurve(modelType, currentParamMap, QVector<double>(), m_modelManager->solverOptions());
+    emit sigIterationUpdated(currentMSE, currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
 
-            QVector<double> delta = solveLinearSystem(H_lm, negG);
-            QMap<QString, double> trialMap = currentParamMap;
+    QMetaObject::invokeMethod(this, "onFitFinished");
+}
 
-            for(int i=0; i<nParams; ++i) {
-                int pIdx = fitIndices[i];
-                QString pName = params[pIdx].name;
-                double oldVal = currentParamMap[pName];
-                bool isLog = (oldVal > 1e-12 && pName != "S" && pName != "nf");
-                double newVal;
+// 参考曲线覆盖观测时间两侧各 kAutoMatchDecades 个对数周期；cD 参与拟合且大于 0 时，
+// 在 cD 的 0.01~100 倍 (半个对数周期一档，不超出参数范围) 中取互相关残差最小的一条参考曲线
+bool FittingWidget::autoMatchParameters(ModelManager::ModelType modelType, QList<FitParameter>& params, double weight, const SolverOptions& options) {
+    if(!m_modelManager || m_obsTime.isEmpty() || m_rateHistory) return false;
 
-                if(isLog) newVal = pow(10.0, log10(oldVal) + delta[i]);
-                else newVal = oldVal + delta[i];
+    QMap<QString, double> baseMap;
+    QStringList freeNames;
+    for(const auto& p : params) {
+        baseMap.insert(p.name, p.value);
+        if(p.isFit) freeNames << p.name;
+    }
+    if(baseMap.contains("L") && baseMap.contains("Lf") && baseMap["L"] > 1e-9)
+        baseMap["LfD"] = baseMap["Lf"] / baseMap["L"];
 
-                newVal = qMax(params[pIdx].min, qMin(newVal, params[pIdx].max));
-                trialMap[pName] = newVal;
-            }
+    double tMin = 1e300, tMax = 0.0;
+    for(double t : m_obsTime) {
+        if(t > 0) { tMin = qMin(tMin, t); tMax = qMax(tMax, t); }
+    }
+    if(tMax <= 0) return false;
+    double startExp = log10(tMin) - kAutoMatchDecades;
+    double endExp = log10(tMax) + kAutoMatchDecades;
+    QVector<double> tRef = ModelManager::generateLogTimeSteps(int((endExp - startExp) * kAutoMatchPointsPerDecade) + 1, startExp, endExp);
 
-            if(trialMap.contains("L") && trialMap.contains("Lf") && trialMap["L"] > 1e-9)
-                trialMap["LfD"] = trialMap["Lf"] / trialMap["L"];
-
-            QVector<double> newRes = calculateResiduals(trialMap, modelType, weight);
-            double newSSE = calculateSumSquaredError(newRes);
-
-            if(newSSE < currentSSE) {
-                currentSSE = newSSE;
-                currentParamMap = trialMap;
-                residuals = newRes;
-                lambda /= 10.0;
-                stepAccepted = true;
-                ModelCurveData iterCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-                emit sigIterationUpdated(currentSSE/nRes, currentParamMap, std::get<0>(iterCurve), std::get<1>(iterCurve), std::get<2>(iterCurve));
-                break;
-            } else {
-                lambda *= 10.0;
-            }
+    QVector<double> cDCandidates;
+    cDCandidates << baseMap.value("cD");
+    for(const auto& p : params) {
+        if(p.name != "cD" || !p.isFit || !(p.value > 0)) continue;
+        for(int k = -4; k <= 4; ++k) {
+            double v = p.value * pow(10.0, 0.5 * k);
+            if(k != 0 && v >= p.min && v <= p.max) cDCandidates << v;
         }
-        if(!stepAccepted && lambda > 1e10) break;
     }
 
-    if(m_modelManager) m_modelManager->setHighPrecision(true);
+    TypeCurveMatch::Shift best;
+    QMap<QString, double> bestMap;
+    for(double cD : cDCandidates) {
+        QMap<QString, double> map = baseMap;
+        if(map.contains("cD")) map["cD"] = cD;
+        // 参考曲线只用于估计平移量，由类型曲线库插值 (库未覆盖时为精确计算)；是否采用由下面的精确残差决定
+        ModelCurveData ref = m_modelManager->calculatePreviewCurve(modelType, map, tRef, options);
+        TypeCurveMatch::Shift shift = TypeCurveMatch::correlate(ref, m_obsTime, m_obsDeltaP, m_obsDerivative, weight, kAutoMatchPointsPerDecade);
+        if(shift.valid && (!best.valid || shift.misfit < best.misfit)) {
+            best = shift;
+            bestMap = map;
+        }
+    }
+    if(!best.valid || !TypeCurveMatch::applyShift(bestMap, best, freeNames)) return false;
 
-    if(currentParamMap.contains("L") && currentParamMap.contains("Lf") && currentParamMap["L"] > 1e-9)
-        currentParamMap["LfD"] = currentParamMap["Lf"] / currentParamMap["L"];
+    // 限制在参数范围内
+    for(const auto& p : params) {
+        if(p.isFit && bestMap.contains(p.name)) bestMap[p.name] = qMax(p.min, qMin(bestMap[p.name], p.max));
+    }
+    if(bestMap.contains("L") && bestMap.contains("Lf") && bestMap["L"] > 1e-9)
+        bestMap["LfD"] = bestMap["Lf"] / bestMap["L"];
 
-    ModelCurveData finalCurve = m_modelManager->calculateTheoreticalCurve(modelType, currentParamMap);
-    emit sigIterationUpdated(currentSSE/residuals.size(), currentParamMap, std::get<0>(finalCurve), std::get<1>(finalCurve), std::get<2>(finalCurve));
+    double oldSSE = calculateSumSquaredError(calculateResiduals(baseMap, modelType, weight, options));
+    double newSSE = calculateSumSquaredError(calculateResiduals(bestMap, modelType, weight, options));
+    if(!(newSSE < oldSSE)) return false;
 
-    QMetaObject::invokeMethod(this, "onFitFinished");
+    for(auto& p : params) {
+        if(bestMap.contains(p.name)) p.value = bestMap[p.name];
+    }
+    return true;
 }
 
-QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight) {
+QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight, const SolverOptions& options) {
     if(!m_modelManager || m_obsTime.isEmpty()) return QVector<double>();
 
-    ModelCurveData res = m_modelManager->calculateTheoreticalCurve(modelType, params, m_obsTime);
+    ModelCurveData res = modelCurve(modelType, params, m_obsTime, options);
     const QVector<double>& pCal = std::get<1>(res);
     const QVector<double>& dpCal = std::get<2>(res);
 
@@ -614,22 +1065,84 @@ QVector<double> FittingWidget::calculateResiduals(const QMap<QString, double>& p
     return r;
 }
 
-QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, double>& params, const QVector<double>& baseResiduals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight) {
-    int nRes = baseResiduals.size();
-    int nParams = fitIndices.size();
-    QVector<QVector<double>> J(nRes, QVector<double>(nParams));
+// 残差 r = (ln(obs) - ln(cal)) * w，故 dr/dθ = -w * (dcal/dθ) / cal；对数参数化时再乘 dθ/dlog10(θ) = θ*ln10
+// 一次灵敏度计算得到全部参数的偏导，不再为每个参数计算两条曲线，也没有差分步长误差
+Eigen::MatrixXd FittingWidget::computeJacobian(const QMap<QString, double>& params, int residualCount, const QStringList& names, const QVector<bool>& logScale, ModelManager::ModelType modelType, double weight, const SolverOptions& options, bool* finiteDifference) {
+    int nRes = residualCount;
+    int nParams = names.size();
+    if(finiteDifference) *finiteDifference = true;
+    // 灵敏度为定产曲线的偏导，变产量拟合时用差分
+    if(!m_modelManager || m_obsTime.isEmpty() || m_rateHistory)
+        return computeFiniteDifferenceJacobian(params, residualCount, names, logScale, modelType, weight, options);
+
+    // Lf 与 L 通过 LfD = Lf / L 进入模型 (与迭代中的参数更新一致)，需要 LfD 的偏导做链式法则
+    bool hasLfD = params.contains("L") && params.contains("Lf") && params.value("L") > 1e-9;
+    QStringList solverNames = names;
+    if(hasLfD && (names.contains("Lf") || names.contains("L"))) solverNames << "LfD";
+
+    CurveSensitivity sens = m_modelManager->calculateSensitivities(modelType, params, m_obsTime, solverNames, options);
+    const QVector<double>& pCal = std::get<1>(sens.curve);
+    const QVector<double>& dpCal = std::get<2>(sens.curve);
+
+    int count = qMin(m_obsDeltaP.size(), pCal.size());
+    int dCount = qMin(qMin(m_obsDerivative.size(), dpCal.size()), count);
+    if(sens.dP.size() != solverNames.size() || count + dCount != nRes)
+        return computeFiniteDifferenceJacobian(params, residualCount, names, logScale, modelType, weight, options);
 
+    if(finiteDifference) *finiteDifference = false;
+    double wp = weight;
+    double wd = 1.0 - weight;
+    int lfdIndex = solverNames.lastIndexOf("LfD");
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(nRes, nParams);
+
+    for(int j = 0; j < nParams; ++j) {
+        QString pName = names[j];
+        double val = params.value(pName);
+        double chain = logScale[j] ? val * log(10.0) : 1.0;
+
+        QVector<double> dP = sens.dP[j];
+        QVector<double> dD = sens.dDeriv[j];
+        if(hasLfD && (pName == "Lf" || pName == "L")) {
+            double L = params.value("L");
+            double factor = (pName == "Lf") ? 1.0 / L : -params.value("Lf") / (L * L);
+            for(int i = 0; i < dP.size(); ++i) {
+                dP[i] += factor * sens.dP[lfdIndex][i];
+                dD[i] += factor * sens.dDeriv[lfdIndex][i];
+            }
+        }
+
+        // J 按列存储，第 j 列连续写入
+        double* column = J.col(j).data();
+        for(int i = 0; i < count; ++i) {
+            if(m_obsDeltaP[i] > 1e-10 && pCal[i] > 1e-10)
+                column[i] = -wp * dP[i] / pCal[i] * chain;
+        }
+        for(int i = 0; i < dCount; ++i) {
+            if(m_obsDerivative[i] > 1e-10 && dpCal[i] > 1e-10)
+                column[count + i] = -wd * dD[i] / dpCal[i] * chain;
+        }
+    }
+    return J;
+}
+
+// 中心差分 Jacobian (对数参数步长 0.01 个对数周期)
+Eigen::MatrixXd FittingWidget::computeFiniteDifferenceJacobian(const QMap<QString, double>& params, int residualCount, const QStringList& names, const QVector<bool>& logScale, ModelManager::ModelType modelType, double weight, const SolverOptions& options) {
+    int nRes = residualCount;
+    int nParams = names.size();
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(nRes, nParams);
+
+    // 第 2j / 2j+1 个扰动参数组为参数 j 的 +h / -h
+    QVector<QMap<QString, double>> perturbed(2 * nParams);
+    QVector<double> steps(nParams);
     for(int j = 0; j < nParams; ++j) {
-        int idx = fitIndices[j];
-        QString pName = currentFitParams[idx].name;
+        QString pName = names[j];
         double val = params.value(pName);
-        bool isLog = (val > 1e-12 && pName != "S" && pName != "nf");
 
         double h;
         QMap<QString, double> pPlus = params;
         QMap<QString, double> pMinus = params;
 
-        if(isLog) {
+        if(logScale[j]) {
             h = 0.01;
             double valLog = log10(val);
             pPlus[pName] = pow(10.0, valLog + h);
@@ -643,39 +1156,36 @@ QVector<QVector<double>> FittingWidget::computeJacobian(const QMap<QString, doub
         auto updateDeps = [](QMap<QString,double>& map) { if(map.contains("L") && map.contains("Lf") && map["L"] > 1e-9) map["LfD"] = map["Lf"] / map["L"]; };
         if(pName == "L" || pName == "Lf") { updateDeps(pPlus); updateDeps(pMinus); }
 
-        QVector<double> rPlus = calculateResiduals(pPlus, modelType, weight);
-        QVector<double> rMinus = calculateResiduals(pMinus, modelType, weight);
+        perturbed[2 * j] = pPlus;
+        perturbed[2 * j + 1] = pMinus;
+        steps[j] = h;
+    }
+
+    // 各扰动曲线相互独立 (求解器与 calculateResiduals 可重入)，并行计算；
+    // 外层已占满线程时每条曲线内部的反演取样不再并行，避免线程过量
+    SolverOptions taskOptions = options;
+    if(taskOptions.threadCount == 0)
+        taskOptions.threadCount = qMax(1, QThread::idealThreadCount() / qMax(1, perturbed.size()));
+    QVector<QVector<double>> results(perturbed.size());
+    QVector<int> tasks(perturbed.size());
+    for(int k = 0; k < tasks.size(); ++k) tasks[k] = k;
+    QtConcurrent::blockingMap(ComputeSupport::pool(ComputeSupport::JacobianPool), tasks, [&](int k) {
+        results[k] = calculateResiduals(perturbed[k], modelType, weight, taskOptions);
+    });
 
+    for(int j = 0; j < nParams; ++j) {
+        const QVector<double>& rPlus = results[2 * j];
+        const QVector<double>& rMinus = results[2 * j + 1];
         if(rPlus.size() == nRes && rMinus.size() == nRes) {
+            double* column = J.col(j).data();
             for(int i=0; i<nRes; ++i) {
-                J[i][j] = (rPlus[i] - rMinus[i]) / (2.0 * h);
+                column[i] = (rPlus[i] - rMinus[i]) / (2.0 * steps[j]);
             }
         }
     }
     return J;
 }
 
-QVector<double> FittingWidget::solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b) {
-    int n = b.size();
-    if (n == 0) return QVector<double>();
-
-    Eigen::MatrixXd matA(n, n);
-    Eigen::VectorXd vecB(n);
-
-    for (int i = 0; i < n; ++i) {
-        vecB(i) = b[i];
-        for (int j = 0; j < n; ++j) {
-            matA(i, j) = A[i][j];
-        }
-    }
-
-    Eigen::VectorXd x = matA.ldlt().solve(vecB);
-
-    QVector<double> res(n);
-    for (int i = 0; i < n; ++i) res[i] = x(i);
-    return res;
-}
-
 double FittingWidget::calculateSumSquaredError(const QVector<double>& residuals) {
     double sse = 0.0;
     for(double v : residuals) sse += v*v;
@@ -699,7 +1209,7 @@ QVector<double> FittingWidget::parseSensitivityValues(const QString& text) {
 }
 
 // [修改] 更新模型曲线：支持敏感性分析（多值多曲线）
-void FittingWidget::updateModelCurve() {
+void FittingWidget::updateModelCurve(bool preview) {
     if(!m_modelManager) {
         QMessageBox::critical(this, "错误", "ModelManager 未初始化！");
         return;
@@ -772,7 +1282,7 @@ void FittingWidget::updateModelCurve() {
                 if(currentParams["L"] > 1e-9) currentParams["LfD"] = currentParams["Lf"] / currentParams["L"];
             }
 
-            ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, currentParams, targetT);
+            ModelCurveData res = modelCurve(type, currentParams, targetT, m_modelManager->solverOptions(), preview);
 
             QColor c = colors[i % colors.size()];
             QString legendSuffix = QString("%1=%2").arg(sensitivityKey).arg(val);
@@ -790,7 +1300,7 @@ void FittingWidget::updateModelCurve() {
         }
     } else {
         // 标准单曲线模式
-        ModelCurveData res = m_modelManager->calculateTheoreticalCurve(type, baseParams, targetT);
+        ModelCurveData res = modelCurve(type, baseParams, targetT, m_modelManager->solverOptions(), preview);
 
         // 调用原有的更新逻辑（包含误差计算）
         // 这里手动调用 plotCurves 会导致添加新 graph，但我们希望复用或者重建 graph(2) 和 (3)
@@ -809,7 +1319,7 @@ void FittingWidget::updateModelCurve() {
 
         // 计算误差（仅在有观测数据时）
         if (!m_obsTime.isEmpty()) {
-            QVector<double> residuals = calculateResiduals(baseParams, type, ui->sliderWeight->value()/100.0);
+            QVector<double> residuals = calculateResiduals(baseParams, type, ui->sliderWeight->value()/100.0, m_modelManager->solverOptions());
             double sse = calculateSumSquaredError(residuals);
             ui->label_Error->setText(QString("误差(MSE): %1").arg(sse/residuals.size(), 0, 'e', 3));
         }
@@ -844,11 +1354,74 @@ void FittingWidget::onIterationUpdate(double err, const QMap<QString,double>& p,
 }
 
 void FittingWidget::onFitFinished() {
+    // 拟合线程结束时 (invokeMethod) 与 m_watcher 结束时各调用一次，只处理第一次
+    if(!m_isFitting) return;
     m_isFitting = false;
     ui->btnRunFit->setEnabled(true);
+    if(!m_globalSolutions.isEmpty()) {
+        QVector<GlobalFitSolution> solutions = m_globalSolutions;
+        m_globalSolutions.clear();
+        showGlobalSolutions(solutions);
+        return;
+    }
     QMessageBox::information(this, "完成", "拟合完成。");
 }
 
+// 全局拟合结果: 按误差排序列出不同的解，选中一行后可写回参数表 (默认已写回最优解)
+void FittingWidget::showGlobalSolutions(const QVector<GlobalFitSolution>& solutions) {
+    m_paramChart->updateParamsFromTable();
+    QStringList fitNames;
+    for(const auto& p : m_paramChart->getParameters()) {
+        if(p.isFit) fitNames << p.name;
+    }
+
+    QDialog dlg(this);
+    dlg.setWindowTitle("全局拟合结果");
+    dlg.resize(640, 360);
+    QVBoxLayout* layout = new QVBoxLayout(&dlg);
+    layout->addWidget(new QLabel(QString("共得到 %1 个不同的解 (按误差排序，已采用第 1 个):").arg(solutions.size()), &dlg));
+
+    QTableWidget* table = new QTableWidget(solutions.size(), 3 + fitNames.size(), &dlg);
+    QStringList headers;
+    headers << "排名" << "误差(MSE)" << "收敛起点数";
+    headers << fitNames;
+    table->setHorizontalHeaderLabels(headers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->setVisible(false);
+    for(int row = 0; row < solutions.size(); ++row) {
+        const GlobalFitSolution& sol = solutions[row];
+        table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
+        table->setItem(row, 1, new QTableWidgetItem(QString::number(sol.meanSquare, 'e', 3)));
+        table->setItem(row, 2, new QTableWidgetItem(QString::number(sol.hits)));
+        for(int j = 0; j < fitNames.size(); ++j)
+            table->setItem(row, 3 + j, new QTableWidgetItem(QString::number(sol.params.value(fitNames[j]), 'g', 5)));
+    }
+    table->resizeColumnsToContents();
+    table->selectRow(0);
+    layout->addWidget(table);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(&dlg);
+    buttons->addButton("采用所选解", QDialogButtonBox::AcceptRole);
+    buttons->addButton("关闭", QDialogButtonBox::RejectRole);
+    connect(buttons, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    connect(table, &QTableWidget::cellDoubleClicked, &dlg, &QDialog::accept);
+    layout->addWidget(buttons);
+
+    if(dlg.exec() != QDialog::Accepted) return;
+    int row = table->currentRow();
+    if(row < 0 || row >= solutions.size()) return;
+
+    QList<FitParameter> params = m_paramChart->getParameters();
+    for(auto& p : params) {
+        if(solutions[row].params.contains(p.name)) p.value = solutions[row].params.value(p.name);
+    }
+    m_paramChart->setParameters(params);
+    updateModelCurve();
+}
+
 void FittingWidget::plotCurves(const QVector<double>& t, const QVector<double>& p, const QVector<double>& d, bool isModel) {
     if (!m_plot) return;
 
@@ -1024,6 +1597,16 @@ QJsonObject FittingWidget::getJsonState() const
     obsData["derivative"] = derivArr;
     root["observedData"] = obsData;
 
+    if (m_rateHistory) {
+        QJsonArray changeArr, rateArr;
+        for(double v : m_rateChangeTimes) changeArr.append(v);
+        for(double v : m_rateValues) rateArr.append(v);
+        QJsonObject history;
+        history["changeTimes"] = changeArr;
+        history["rates"] = rateArr;
+        root["rateHistory"] = history;
+    }
+
     return root;
 }
 
@@ -1091,6 +1674,14 @@ void FittingWidget::loadFittingState(const QJsonObject& root)
         setObservedData(t, p, d);
     }
 
+    if (root.contains("rateHistory")) {
+        QJsonObject history = root["rateHistory"].toObject();
+        QVector<double> changeTimes, rates;
+        for(auto v : history["changeTimes"].toArray()) changeTimes.append(v.toDouble());
+        for(auto v : history["rates"].toArray()) rates.append(v.toDouble());
+        setRateHistory(changeTimes, rates);
+    }
+
     updateModelCurve();
 
     if (root.contains("plotView")) {
@@ -7,6 +7,13 @@
  * 3. 声明观测数据（时间、压差、导数）的管理函数。
  * 4. 支持多文件数据源。
  * 5. [新增] 支持参数敏感性分析（多值输入绘制多条曲线）。
+ * 6. 滚轮调参时先用类型曲线库预览，停止调节后再按精确解重绘。
+ * 7. 变产量的压力 + 产量数据可经反褶积 (Deconvolution) 得到定产压差与导数，作为观测数据。
+ * 8. 自动初值: 双对数曲线互相关 (TypeCurveMatch) 求时间与压力平移，换算为缩放参数作为 LM 的起点。
+ * 9. LM 迭代交给不依赖界面的 LevenbergMarquardt，本类提供残差、Jacobian 与参数映射。
+ * 10. 全局拟合: 多起点 (MultiStartFit) 并发拟合，结束后列出按误差排序的不同解供选择。
+ * 11. 差分进化 (DifferentialEvolution): 无需导数、每代成批并行求值的全局搜索，结束后用 LM 精修。
+ * 12. 变产量历史拟合: 加载压力 + 产量数据后，残差与理论曲线按产量历史叠加 (RateSuperposition) 计算。
  */
 
 #ifndef WT_FITTINGWIDGET_H
@@ -16,9 +23,14 @@
 #include <QMap>
 #include <QVector>
 #include <QFutureWatcher>
+#include <QTimer>
 #include <QJsonObject>
 #include <QStandardItemModel>
+#include <Eigen/Dense>
+#include <QSharedPointer>
+#include <atomic>
 #include "modelmanager.h"
+#include "levenbergmarquardt.h"
 #include "mousezoom.h"
 #include "chartwidget.h"
 #include "fittingparameterchart.h"
@@ -62,11 +74,14 @@ signals:
 private slots:
     // 数据加载与模型选择
     void on_btnLoadData_clicked();
+    void on_btnDeconvolution_clicked();
+    void on_btnRateHistory_clicked();
     void on_btn_modelSelect_clicked();
 
     // 参数管理
     void on_btnSelectParams_clicked();
     void on_btnResetParams_clicked();
+    void on_btnAutoMatch_clicked();
 
     // 拟合控制
     void on_btnRunFit_clicked();
@@ -84,6 +99,7 @@ private slots:
     // 内部拟合逻辑槽函数
     void onIterationUpdate(double err, const QMap<QString,double>& p, const QVector<double>& t, const QVector<double>& p_curve, const QVector<double>& d_curve);
     void onFitFinished();
+    void onAutoMatchFinished();
     void onSliderWeightChanged(int value);
 
 private:
@@ -109,24 +125,78 @@ private:
     QVector<double> m_obsDeltaP;
     QVector<double> m_obsDerivative;
 
+    // 变产量历史 (为空时按定产计算): 升序的产量变化时刻与各段产量，m_rateHistory 为由其构造的叠加对象
+    QVector<double> m_rateChangeTimes;
+    QVector<double> m_rateValues;
+    QSharedPointer<const RateSuperposition> m_rateHistory;
+
     // 拟合状态控制
     bool m_isFitting;
-    bool m_stopRequested;
+    std::atomic<bool> m_stopRequested;   // 界面线程写、拟合线程读
+    bool m_autoMatchBeforeFit;     // 本次拟合开始前是否先自动匹配初值 (启动拟合时读取界面选项)
+    // 拟合算法 (与 comboFitMethod 的选项顺序一致)
+    enum FitMethod {
+        FitLevenbergMarquardt = 0,
+        FitMultiStart,
+        FitDifferentialEvolution
+    };
+    int m_fitMethod;               // 本次拟合的算法 (启动拟合时读取界面选项)
+    int m_globalStartCount;        // 全局拟合的起点数 (含参数表当前值)
     QFutureWatcher<void> m_watcher;
+    QFutureWatcher<QList<FitParameter>> m_autoMatchWatcher;   // 自动初值的后台计算 (结果为空表示未找到更好的初值)
+
+    // 全局拟合得到的不同解 (按误差排序)
+    struct GlobalFitSolution {
+        QMap<QString, double> params;
+        double meanSquare = 0.0;
+        int hits = 1;               // 收敛到该解的起点数
+    };
+    QVector<GlobalFitSolution> m_globalSolutions;
+    // 全局拟合结束后列出各个解，选中的解写回参数表
+    void showGlobalSolutions(const QVector<GlobalFitSolution>& solutions);
+
+    // 参与拟合的参数与优化变量 x 的对应: 对数参数为 log10(值)，其余为原值；base 为全部参数的当前值
+    struct FitVariables {
+        QStringList names;
+        QVector<bool> logScale;
+        Eigen::VectorXd x0, lower, upper;
+        QMap<QString, double> base;
+        QMap<QString, double> toParamMap(const Eigen::VectorXd& x) const;
+    };
+
+    // 滚轮调参停止后触发精确重绘
+    QTimer m_exactRedrawTimer;
 
     // 初始化图表设置
     void setupPlot();
     // 初始化默认模型
     void initializeDefaultModel();
-    // 更新模型曲线（[修改] 包含敏感性分析逻辑）
-    void updateModelCurve();
+    // 更新模型曲线（[修改] 包含敏感性分析逻辑）；preview 为真时由类型曲线库快速计算 (库未覆盖时自动按精确解)
+    void updateModelCurve(bool preview = false);
+    // 设置变产量历史 (须在 setObservedData 之后调用，setObservedData 会清除产量历史)
+    void setRateHistory(const QVector<double>& changeTimes, const QVector<double>& rates);
+    // 理论曲线: 有产量历史时按变产量叠加 (t 为空时取观测时刻，不使用预览)，否则为定产曲线
+    ModelCurveData modelCurve(ModelManager::ModelType modelType, const QMap<QString, double>& params, const QVector<double>& t,
+                              const SolverOptions& options, bool preview = false);
 
     // 核心拟合算法函数 (Levenberg-Marquardt)
     void runOptimizationTask(ModelManager::ModelType modelType, QList<FitParameter> fitParams, double weight);
     void runLevenbergMarquardtOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
-    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight);
-    QVector<QVector<double>> computeJacobian(const QMap<QString, double>& params, const QVector<double>& residuals, const QVector<int>& fitIndices, ModelManager::ModelType modelType, const QList<FitParameter>& currentFitParams, double weight);
-    QVector<double> solveLinearSystem(const QVector<QVector<double>>& A, const QVector<double>& b);
+    void runGlobalOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
+    void runEvolutionOptimization(ModelManager::ModelType modelType, QList<FitParameter> params, double weight);
+    SolverOptions fitSolverOptions() const;
+    static FitVariables makeFitVariables(const QList<FitParameter>& params);
+    static void samplingBounds(const FitVariables& vars, Eigen::VectorXd& lower, Eigen::VectorXd& upper);
+    LevenbergMarquardt::Problem makeFitProblem(ModelManager::ModelType modelType, const FitVariables& vars, double weight, const SolverOptions& options);
+    // options 为本次计算的求解器选项 (拟合线程使用自己的拟合精度，不修改全局设置)
+    QVector<double> calculateResiduals(const QMap<QString, double>& params, ModelManager::ModelType modelType, double weight, const SolverOptions& options);
+    // Jacobian (residualCount x names.size()，按列存储): 由求解器的自动微分灵敏度直接构造；
+    // 灵敏度不可用或变产量拟合时退回中心差分 (2*nParams 条扰动曲线并行计算，finiteDifference 非空时输出是否退回)。
+    // logScale[j] 为真时对 log10(参数) 求导
+    Eigen::MatrixXd computeJacobian(const QMap<QString, double>& params, int residualCount, const QStringList& names, const QVector<bool>& logScale, ModelManager::ModelType modelType, double weight, const SolverOptions& options, bool* finiteDifference = nullptr);
+    Eigen::MatrixXd computeFiniteDifferenceJacobian(const QMap<QString, double>& params, int residualCount, const QStringList& names, const QVector<bool>& logScale, ModelManager::ModelType modelType, double weight, const SolverOptions& options);
+    // 自动初值: 参考曲线与观测数据互相关后换算参与拟合的缩放参数 (及 cD)；残差平方和下降时写回 params 并返回 true
+    bool autoMatchParameters(ModelManager::ModelType modelType, QList<FitParameter>& params, double weight, const SolverOptions& options);
     double calculateSumSquaredError(const QVector<double>& residuals);
 
     // 辅助绘图函数
@@ -74,17 +74,37 @@ void WT_ModelWidget::setHighPrecision(bool high)
     if (m_solver) m_solver->setHighPrecision(high);
 }
 
+void WT_ModelWidget::setInversionMethod(LaplaceInversion::Method method, int order)
+{
+    if (m_solver) m_solver->setInversionMethod(method, order);
+}
+
+void WT_ModelWidget::setThreadCount(int count)
+{
+    if (m_solver) m_solver->setThreadCount(count);
+}
+
+void WT_ModelWidget::setAsymptoticTolerance(double tol)
+{
+    if (m_solver) m_solver->setAsymptoticTolerance(tol);
+}
+
+void WT_ModelWidget::setInversionTolerance(double tol)
+{
+    if (m_solver) m_solver->setInversionTolerance(tol);
+}
+
+void WT_ModelWidget::setTypeCurveLibrary(const TypeCurveLibrary* library)
+{
+    if (m_solver) m_solver->setTypeCurveLibrary(library);
+}
+
 void WT_ModelWidget::initUi() {
-    using MT = ModelSolver01_06::ModelType;
-    if (m_type == MT::Model_1 || m_type == MT::Model_2) {
-        ui->label_reD->setVisible(false);
-        ui->reDEdit->setVisible(false);
-    } else {
-        ui->label_reD->setVisible(true);
-        ui->reDEdit->setVisible(true);
-    }
+    const ModelSolver01_06::ModelKernel& kernel = ModelSolver01_06::modelKernel(m_type);
+    ui->label_reD->setVisible(kernel.bounded);
+    ui->reDEdit->setVisible(kernel.bounded);
 
-    bool hasStorage = (m_type == MT::Model_1 || m_type == MT::Model_3 || m_type == MT::Model_5);
+    bool hasStorage = kernel.hasStorage;
     ui->label_cD->setVisible(hasStorage);
     ui->cDEdit->setVisible(hasStorage);
     ui->label_s->setVisible(hasStorage);
@@ -167,7 +187,7 @@ void WT_ModelWidget::setInputText(QLineEdit* edit, double value) {
 
 // 重置参数函数
 void WT_ModelWidget::onResetParameters() {
-    using MT = ModelSolver01_06::ModelType;
+    const ModelSolver01_06::ModelKernel& kernel = ModelSolver01_06::modelKernel(m_type);
     ModelParameter* mp = ModelParameter::instance();
 
     setInputText(ui->phiEdit, mp->getPhi());
@@ -191,13 +211,11 @@ void WT_ModelWidget::onResetParameters() {
     setInputText(ui->remda1Edit, 0.001);
     setInputText(ui->gamaDEdit, 0.02);
 
-    bool isInfinite = (m_type == MT::Model_1 || m_type == MT::Model_2);
-    if (!isInfinite) {
+    if (kernel.bounded) {
         setInputText(ui->reDEdit, 10.0);
     }
 
-    bool hasStorage = (m_type == MT::Model_1 || m_type == MT::Model_3 || m_type == MT::Model_5);
-    if (hasStorage) {
+    if (kernel.hasStorage) {
         setInputText(ui->cDEdit, 0.01);
         setInputText(ui->sEdit, 1.0);
     }
@@ -316,8 +334,9 @@ void WT_ModelWidget::runCalculation() {
             }
         }
 
-        // 调用 Solver 计算
-        ModelCurveData res = calculateTheoreticalCurve(currentParams, t);
+        // 调用 Solver 计算 (敏感性分析的对比曲线用类型曲线库预览，库未覆盖时即精确计算)
+        ModelCurveData res = (isSensitivity && m_solver) ? m_solver->calculatePreviewCurve(currentParams, t)
+                                                         : calculateTheoreticalCurve(currentParams, t);
 
         // 缓存最后一次结果用于显示
         res_tD = std::get<0>(res);
@@ -37,6 +37,16 @@ public:
 
     // 设置高精度模式（转发给 Solver）
     void setHighPrecision(bool high);
+    // 设置拉普拉斯反演算法（转发给 Solver）
+    void setInversionMethod(LaplaceInversion::Method method, int order = 0);
+    // 设置反演取样线程数（转发给 Solver）
+    void setThreadCount(int count);
+    // 设置渐近段捷径容差（转发给 Solver，0 为关闭）
+    void setAsymptoticTolerance(double tol);
+    // 设置 Stehfest 自适应选阶容差（转发给 Solver，0 为固定阶数）
+    void setInversionTolerance(double tol);
+    // 设置类型曲线库（转发给 Solver，敏感性分析的多条曲线用库预览）
+    void setTypeCurveLibrary(const TypeCurveLibrary* library);
     // 直接调用求解器计算（供外部管理器使用，非 UI 交互）
     ModelCurveData calculateTheoreticalCurve(const QMap<QString, double>& params, const QVector<double>& providedTime = QVector<double>());
     // 获取当前模型名称